@@ -0,0 +1,1567 @@
+// Micro benchmarks for the linked list implementations.
+// Run "make bench" to run all of them or "./llbench <name>" to run a single one.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrentlinkedqueue.hpp"
+#include "epochreclaimer.hpp"
+#include "helpers.hpp"
+#include "linkedlist.hpp"
+#include "unrolledlinkedlist.hpp"
+#include "doublylinkedlist.hpp"
+#include "finegrainedlinkedlist.hpp"
+#include "indexedbyvaluelinkedlist.hpp"
+#include "indexedlinkedlist.hpp"
+#include "shardedlinkedlist.hpp"
+#include "simdsearch.hpp"
+#include "snapshotlinkedlist.hpp"
+#include "spsclinkedlist.hpp"
+#include "stripedcounter.hpp"
+#include "threadpool.hpp"
+
+using namespace std;
+
+/// @brief Number of calls to the global operator new since the program started.
+static atomic<size_t> heapAllocations(0);
+
+/// @brief Number of bytes requested from the global operator new since the program started.
+static atomic<size_t> heapBytes(0);
+
+[[gnu::noinline]] void *operator new(size_t size)
+{
+    heapAllocations++;
+    heapBytes += size;
+
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+// Kept out of line so the compiler does not see free() paired with a pointer from operator new.
+[[gnu::noinline]] void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/// @brief Measures the wall clock time and heap allocations of a piece of work.
+class Measurement
+{
+public:
+    Measurement() : _start(chrono::steady_clock::now()), _allocations(heapAllocations), _bytes(heapBytes) {}
+
+    /// @brief Prints the elapsed time and allocation count since construction.
+    /// @param label The label to print in front of the numbers.
+    void Report(const string &label) const
+    {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - _start).count();
+        cout << "  " << label << ": " << ms << " ms, " << (heapAllocations - _allocations) << " heap allocations, "
+             << (heapBytes - _bytes) / 1024 << " KiB" << endl;
+    }
+
+    chrono::steady_clock::time_point Start() const
+    {
+        return _start;
+    }
+
+private:
+    chrono::steady_clock::time_point _start;
+    size_t _allocations;
+    size_t _bytes;
+};
+
+/// @brief A single list command parsed from a test script.
+struct ScriptCommand
+{
+    string name;
+    vector<int> args;
+};
+
+/// @brief Indicates if ReplayScript handles a command.  Other commands are dropped when loading a script.
+bool IsReplayedCommand(const string &name)
+{
+    return name == "append" || name == "prepend" || name == "insertat" || name == "removeat" || name == "clear";
+}
+
+/// @brief Loads the list commands of a test script so they can be replayed without parsing overhead.
+/// @param filename The test script to load.
+/// @return The commands in the order they appear in the file.
+vector<ScriptCommand> LoadScript(const string &filename)
+{
+    vector<ScriptCommand> commands;
+    ifstream file(filename);
+    string line;
+
+    while (getline(file, line))
+    {
+        string command, expected, comment;
+        ParseLine(trim(line), command, expected, comment, ';', '#');
+
+        vector<string> parts = SplitString(command);
+        if (parts.empty() || !IsReplayedCommand(parts[0]))
+        {
+            continue;
+        }
+
+        ScriptCommand scriptCommand;
+        scriptCommand.name = parts[0];
+        for (size_t i = 1; i < parts.size(); i++)
+        {
+            scriptCommand.args.push_back(stoi(parts[i]));
+        }
+        commands.push_back(scriptCommand);
+    }
+
+    return commands;
+}
+
+/// @brief Replays the mutating commands of a script against a list.
+template <typename List>
+void ReplayScript(List &list, const vector<ScriptCommand> &commands)
+{
+    for (const ScriptCommand &command : commands)
+    {
+        try
+        {
+            if (command.name == "append")
+                list.Append(command.args[0]);
+            else if (command.name == "prepend")
+                list.Prepend(command.args[0]);
+            else if (command.name == "insertat")
+                list.InsertAt(command.args[0], command.args[1]);
+            else if (command.name == "removeat")
+                list.RemoveAt(command.args[0]);
+            else if (command.name == "clear")
+                list.Clear();
+        }
+        catch (const LinkedListException &)
+        {
+        }
+    }
+}
+
+template <typename List>
+void BenchScript(const string &label, const vector<ScriptCommand> &commands, int repetitions)
+{
+    Measurement measurement;
+
+    for (int i = 0; i < repetitions; i++)
+    {
+        List list;
+        ReplayScript(list, commands);
+    }
+
+    measurement.Report(label);
+}
+
+template <typename List>
+void BenchAppendHeavy(const string &label, int count, int rounds)
+{
+    Measurement measurement;
+    List list;
+
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            list.Append(i);
+        }
+        for (int i = 0; i < count / 2; i++)
+        {
+            list.RemoveAt(0);
+        }
+        list.Clear();
+    }
+
+    measurement.Report(label);
+}
+
+/// @brief Compares the pooled node allocator with one heap allocation per node.
+void BenchAllocator()
+{
+    const int repetitions = 20000;
+    vector<ScriptCommand> commands = LoadScript("lltest.txt");
+
+    cout << "allocator: lltest.txt replayed " << repetitions << " times" << endl;
+    BenchScript<LinkedList<int, allocator<int>>>("std::allocator", commands, repetitions);
+    BenchScript<LinkedList<int>>("NodePool      ", commands, repetitions);
+
+    cout << "allocator: append 1000000, remove half from the front, clear, 5 rounds" << endl;
+    BenchAppendHeavy<LinkedList<int, allocator<int>>>("std::allocator", 1000000, 5);
+    BenchAppendHeavy<LinkedList<int>>("NodePool      ", 1000000, 5);
+}
+
+template <typename List>
+void BenchScan(const string &label, int count)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    Measurement measurement;
+    long long sum = 0;
+
+    for (int round = 0; round < 10; round++)
+    {
+        list.ForEach([&sum](const int &value)
+                     { sum += value; });
+        sum += list.FindIndex([count](const int &value)
+                              { return value == count - 1; });
+    }
+    for (int i = 0; i < count; i += count / 100)
+    {
+        sum += list.Get(i);
+    }
+
+    measurement.Report(label + " (checksum " + to_string(sum) + ")");
+}
+
+/// @brief Compares scans over one element per node with scans over an unrolled list.
+void BenchUnrolled()
+{
+    cout << "unrolled: 10 x (ForEach + FindIndex) and 100 x Get over 1000000 elements" << endl;
+    BenchScan<LinkedList<int>>("LinkedList             ", 1000000);
+    BenchScan<UnrolledLinkedList<int, 16>>("UnrolledLinkedList<16> ", 1000000);
+    BenchScan<UnrolledLinkedList<int, 64>>("UnrolledLinkedList<64> ", 1000000);
+}
+
+/// @brief Equality searches for a value at the very end: a predicate walk versus FindIndexOfValue, and
+/// counting with ForEach versus Count.
+template <typename List>
+void BenchValueSearch(const string &label, int count, int repeats)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(static_cast<int>(random() % 1000));
+    }
+    list.Append(-1);
+
+    volatile long long sink = 0;
+    {
+        Measurement measurement;
+        for (int r = 0; r < repeats; r++)
+        {
+            sink = sink + list.FindIndex([](const int &value)
+                                         { return value == -1; });
+        }
+        measurement.Report(label + " FindIndex(pred)   ");
+    }
+    {
+        Measurement measurement;
+        for (int r = 0; r < repeats; r++)
+        {
+            sink = sink + list.FindIndexOfValue(-1);
+        }
+        measurement.Report(label + " FindIndexOfValue  ");
+    }
+    {
+        Measurement measurement;
+        for (int r = 0; r < repeats; r++)
+        {
+            int matches = 0;
+            list.ForEach([&matches](const int &value)
+                         { matches += value == 500; });
+            sink = sink + matches;
+        }
+        measurement.Report(label + " ForEach counting  ");
+    }
+    {
+        Measurement measurement;
+        for (int r = 0; r < repeats; r++)
+        {
+            sink = sink + list.Count(500);
+        }
+        measurement.Report(label + " Count(value)      ");
+    }
+}
+
+void BenchSimd()
+{
+    cout << "simd: 10 x each search over 1000000 ints, vector kernels use " << SimdInstructionSet() << endl;
+    BenchValueSearch<LinkedList<int>>("LinkedList            ", 1000000, 10);
+    BenchValueSearch<UnrolledLinkedList<int, 16>>("UnrolledLinkedList<16>", 1000000, 10);
+    BenchValueSearch<UnrolledLinkedList<int, 64>>("UnrolledLinkedList<64>", 1000000, 10);
+}
+
+/// @brief Sequential positional access, which resumes from the list's cursor.
+void BenchCursor()
+{
+    const int count = 200000;
+    LinkedList<int> list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    cout << "cursor: " << count << " elements" << endl;
+    {
+        Measurement measurement;
+        long long sum = 0;
+        for (int i = 0; i < count; i++)
+        {
+            sum += list.Get(i);
+        }
+        measurement.Report("Get(i) for i = 0..n      (checksum " + to_string(sum) + ")");
+    }
+    {
+        Measurement measurement;
+        for (int i = 1; i < count; i += 2)
+        {
+            list.InsertAt(-i, i);
+        }
+        measurement.Report("InsertAt every other slot");
+    }
+    {
+        Measurement measurement;
+        for (int i = 1; i < list.Size(); i++)
+        {
+            list.RemoveAt(i);
+        }
+        measurement.Report("RemoveAt every other slot");
+    }
+}
+
+template <typename List>
+void BenchTailAccess(const string &label, int count)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    Measurement measurement;
+    long long sum = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        sum += list.Get(count - 1 - i % 100);
+    }
+    while (!list.Empty())
+    {
+        list.RemoveAt(list.Size() - 1);
+    }
+
+    measurement.Report(label + " (checksum " + to_string(sum) + ")");
+}
+
+/// @brief Positional access near the tail, which a doubly linked list reaches from the tail.
+void BenchDoubly()
+{
+    cout << "doubly: 1000 x Get near the tail, then RemoveAt(Size() - 1) until empty, 20000 elements" << endl;
+    BenchTailAccess<LinkedList<int>>("LinkedList      ", 20000);
+    BenchTailAccess<DoublyLinkedList<int>>("DoublyLinkedList", 20000);
+}
+
+/// @brief Copying, moving and emplacing string payloads, then reading them back by reference.
+void BenchMove()
+{
+    const int count = 200000;
+    const string payload(64, 'x');
+
+    cout << "move: " << count << " strings of " << payload.size() << " characters" << endl;
+    {
+        Measurement measurement;
+        LinkedList<string> list;
+        for (int i = 0; i < count; i++)
+        {
+            string value(payload);
+            list.Append(static_cast<const string &>(value));
+        }
+        measurement.Report("Append(const T &)   ");
+    }
+    {
+        Measurement measurement;
+        LinkedList<string> list;
+        for (int i = 0; i < count; i++)
+        {
+            string value(payload);
+            list.Append(std::move(value));
+        }
+        measurement.Report("Append(T &&)        ");
+    }
+    {
+        Measurement measurement;
+        LinkedList<string> list;
+        for (int i = 0; i < count; i++)
+        {
+            list.EmplaceBack(payload.size(), 'x');
+        }
+
+        size_t length = 0;
+        for (int i = 0; i < count; i++)
+        {
+            length += list.Get(i).size();
+        }
+        measurement.Report("EmplaceBack + Get   (length " + to_string(length) + ")");
+    }
+}
+
+/// @brief Loading a list one Append at a time versus one AppendRange.
+void BenchBulkLoad()
+{
+    const int count = 1000000;
+    vector<int> values;
+    for (int i = 0; i < count; i++)
+    {
+        values.push_back(i);
+    }
+
+    cout << "bulk: load " << count << " values, 5 rounds" << endl;
+    {
+        Measurement measurement;
+        for (int round = 0; round < 5; round++)
+        {
+            LinkedList<int> list;
+            for (int value : values)
+            {
+                list.Append(value);
+            }
+        }
+        measurement.Report("Append      ");
+    }
+    {
+        Measurement measurement;
+        for (int round = 0; round < 5; round++)
+        {
+            LinkedList<int> list;
+            list.AppendRange(values.begin(), values.end());
+        }
+        measurement.Report("AppendRange ");
+    }
+}
+
+/// @brief Merging per-worker result lists by copying versus splicing.
+void BenchSplice()
+{
+    const int workers = 16;
+    const int count = 100000;
+
+    cout << "splice: merge " << workers << " lists of " << count << " elements" << endl;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        vector<LinkedList<int>> results(workers);
+        for (LinkedList<int> &result : results)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                result.Append(i);
+            }
+        }
+
+        Measurement measurement;
+        LinkedList<int> merged;
+
+        for (LinkedList<int> &result : results)
+        {
+            if (mode == 0)
+            {
+                result.ForEach([&merged](const int &value)
+                               { merged.Append(value); });
+            }
+            else
+            {
+                merged.Splice(std::move(result));
+            }
+        }
+        measurement.Report(mode == 0 ? "ForEach + Append" : "Splice          ");
+    }
+}
+
+/// @brief Fills a list with pseudo random values that are the same on every run.
+template <typename List>
+void FillRandom(List &list, int count)
+{
+    mt19937 random(12345);
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(static_cast<int>(random() % 1000000));
+    }
+}
+
+/// @brief Sorting in place versus copying into a vector, sorting, and rebuilding the list.
+void BenchSort()
+{
+    const int count = 1000000;
+
+    cout << "sort: " << count << " random values" << endl;
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        vector<int> values(list.begin(), list.end());
+        sort(values.begin(), values.end());
+        list.Clear();
+        list.AppendRange(values.begin(), values.end());
+        measurement.Report("copy, std::sort, rebuild");
+    }
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        list.Sort();
+        measurement.Report("Sort in place           ");
+    }
+}
+
+/// @brief Removing the even values one RemoveAt at a time versus one RemoveIf, and the middle half of
+/// the list with RemoveAt versus one RemoveRange.
+void BenchRemove()
+{
+    const int count = 20000;
+
+    cout << "remove: even values of " << count << endl;
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        for (int i = list.Size() - 1; i >= 0; i--)
+        {
+            if (list.Get(i) % 2 == 0)
+            {
+                list.RemoveAt(i);
+            }
+        }
+        measurement.Report("RemoveAt from the back ");
+    }
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        list.RemoveIf([](int value)
+                      { return value % 2 == 0; });
+        measurement.Report("RemoveIf               ");
+    }
+
+    cout << "remove: middle half of " << count << endl;
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        for (int i = 0; i < count / 2; i++)
+        {
+            list.RemoveAt(count / 4);
+        }
+        measurement.Report("RemoveAt               ");
+    }
+    {
+        LinkedList<int> list;
+        FillRandom(list, count);
+
+        Measurement measurement;
+        list.RemoveRange(count / 4, count / 2);
+        measurement.Report("RemoveRange            ");
+    }
+}
+
+/// @brief Sum of the squares of the even values: one ForEach into a temporary per stage, versus a
+/// fused View pipeline that walks the list once.  Also the first few matches, where Take ends the walk early.
+void BenchView()
+{
+    const int count = 1000000;
+    const int take = 10;
+
+    LinkedList<int> list;
+    FillRandom(list, count);
+
+    cout << "view: filter, map and reduce over " << count << " values" << endl;
+    volatile long long sink = 0;
+    {
+        Measurement measurement;
+        LinkedList<int> evens;
+        list.ForEach([&evens](int value)
+                     {
+                         if (value % 2 == 0)
+                         {
+                             evens.Append(value);
+                         }
+                     });
+        LinkedList<long long> squares;
+        evens.ForEach([&squares](int value)
+                      { squares.Append(static_cast<long long>(value) * value); });
+        long long total = 0;
+        squares.ForEach([&total](long long value)
+                        { total += value; });
+        sink = sink + total;
+        measurement.Report("staged LinkedLists");
+    }
+    {
+        Measurement measurement;
+        vector<int> evens;
+        list.ForEach([&evens](int value)
+                     {
+                         if (value % 2 == 0)
+                         {
+                             evens.push_back(value);
+                         }
+                     });
+        vector<long long> squares;
+        for (int value : evens)
+        {
+            squares.push_back(static_cast<long long>(value) * value);
+        }
+        long long total = 0;
+        for (long long value : squares)
+        {
+            total += value;
+        }
+        sink = sink + total;
+        measurement.Report("staged vectors    ");
+    }
+    {
+        Measurement measurement;
+        sink = sink + list.View()
+                          .Filter([](int value)
+                                  { return value % 2 == 0; })
+                          .Map([](int value)
+                               { return static_cast<long long>(value) * value; })
+                          .Reduce(0LL, [](long long total, long long value)
+                                  { return total + value; });
+        measurement.Report("fused View        ");
+    }
+
+    cout << "view: first " << take << " even values of " << count << endl;
+    {
+        Measurement measurement;
+        vector<int> evens;
+        list.ForEach([&evens](int value)
+                     {
+                         if (value % 2 == 0)
+                         {
+                             evens.push_back(value);
+                         }
+                     });
+        evens.resize(evens.size() < take ? evens.size() : take);
+        sink = sink + static_cast<long long>(evens.size());
+        measurement.Report("staged vector     ");
+    }
+    {
+        Measurement measurement;
+        LinkedList<int> evens;
+        list.View().Filter([](int value)
+                           { return value % 2 == 0; })
+            .Take(take)
+            .CollectInto(evens);
+        sink = sink + evens.Size();
+        measurement.Report("fused View, Take  ");
+    }
+}
+
+template <typename List>
+void BenchRandomPositions(const string &label, int count, int operations)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    mt19937 random(777);
+    Measurement measurement;
+    long long sum = 0;
+
+    for (int i = 0; i < operations; i++)
+    {
+        int position = static_cast<int>(random() % list.Size());
+        switch (i % 3)
+        {
+        case 0:
+            sum += list.Get(position);
+            break;
+        case 1:
+            list.InsertAt(i, position);
+            break;
+        default:
+            list.RemoveAt(position);
+            break;
+        }
+    }
+
+    measurement.Report(label + " (checksum " + to_string(sum) + ")");
+}
+
+/// @brief Random positional access on a plain list versus the skip list index.
+void BenchIndexed()
+{
+    cout << "indexed: 3000 random Get/InsertAt/RemoveAt on 300000 elements" << endl;
+    BenchRandomPositions<LinkedList<int>>("LinkedList       ", 300000, 3000);
+    BenchRandomPositions<IndexedLinkedList<int>>("IndexedLinkedList", 300000, 3000);
+
+    cout << "indexed: 300000 random Get/InsertAt/RemoveAt on 3000000 elements" << endl;
+    BenchRandomPositions<IndexedLinkedList<int>>("IndexedLinkedList", 3000000, 300000);
+}
+
+/// @brief Lookups by value, half of them for values that are not in the list: a predicate scan of a
+/// LinkedList versus the hash index of IndexedByValueLinkedList, plus what keeping the index costs appends.
+void BenchByValue()
+{
+    const int count = 100000;
+    const int lookups = 2000;
+
+    cout << "byvalue: " << count << " appends, then " << lookups << " lookups by value" << endl;
+
+    LinkedList<int> list;
+    {
+        Measurement measurement;
+        for (int i = 0; i < count; i++)
+        {
+            list.Append(i * 2);
+        }
+        measurement.Report("LinkedList               Append   ");
+    }
+    IndexedByValueLinkedList<int> indexed;
+    {
+        Measurement measurement;
+        for (int i = 0; i < count; i++)
+        {
+            indexed.Append(i * 2);
+        }
+        measurement.Report("IndexedByValueLinkedList Append   ");
+    }
+
+    mt19937 random(99);
+    vector<int> values;
+    for (int i = 0; i < lookups; i++)
+    {
+        values.push_back(static_cast<int>(random() % (count * 2)));
+    }
+
+    volatile long long sink = 0;
+    {
+        Measurement measurement;
+        for (int value : values)
+        {
+            sink = sink + list.Count(value);
+        }
+        measurement.Report("LinkedList               Count    ");
+    }
+    {
+        Measurement measurement;
+        for (int value : values)
+        {
+            sink = sink + indexed.Contains(value);
+        }
+        measurement.Report("IndexedByValueLinkedList Contains ");
+    }
+    {
+        Measurement measurement;
+        for (int value : values)
+        {
+            try
+            {
+                sink = sink + list.Find([value](const int &element)
+                                        { return element == value; });
+            }
+            catch (const LinkedListException &)
+            {
+            }
+        }
+        measurement.Report("LinkedList               Find     ");
+    }
+    {
+        Measurement measurement;
+        for (int value : values)
+        {
+            try
+            {
+                sink = sink + indexed.FindValue(value);
+            }
+            catch (const LinkedListException &)
+            {
+            }
+        }
+        measurement.Report("IndexedByValueLinkedList FindValue");
+    }
+}
+
+/// @brief Lookups at several hit ratios, through the throwing functions and their Try counterparts:
+/// Get/TryGet by position on a short LinkedList, and FindValue/TryFindValue on an IndexedByValueLinkedList.
+void BenchTry()
+{
+    const int count = 64;
+    const int lookups = 200000;
+    const int hitPercents[] = {100, 90, 50, 10, 0};
+
+    LinkedList<int> list;
+    IndexedByValueLinkedList<int> indexed;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+        indexed.Append(i);
+    }
+
+    cout << "try: " << lookups << " lookups on " << count << " elements" << endl;
+    for (int hitPercent : hitPercents)
+    {
+        // Keys below count hit, the others miss.
+        mt19937 random(hitPercent);
+        vector<int> keys;
+        for (int i = 0; i < lookups; i++)
+        {
+            keys.push_back(static_cast<int>(random() % 100) < hitPercent ? static_cast<int>(random() % count) : count + static_cast<int>(random() % count));
+        }
+
+        string ratio = to_string(hitPercent) + "% hits";
+        ratio.resize(9, ' ');
+        volatile long long sink = 0;
+        {
+            Measurement measurement;
+            for (int key : keys)
+            {
+                try
+                {
+                    sink = sink + list.Get(key);
+                }
+                catch (const LinkedListException &)
+                {
+                    sink = sink - 1;
+                }
+            }
+            measurement.Report(ratio + " Get         ");
+        }
+        {
+            Measurement measurement;
+            for (int key : keys)
+            {
+                int value;
+                sink = sink + (list.TryGet(key, value) ? value : -1);
+            }
+            measurement.Report(ratio + " TryGet      ");
+        }
+        {
+            Measurement measurement;
+            for (int key : keys)
+            {
+                try
+                {
+                    sink = sink + indexed.FindValue(key);
+                }
+                catch (const LinkedListException &)
+                {
+                    sink = sink - 1;
+                }
+            }
+            measurement.Report(ratio + " FindValue   ");
+        }
+        {
+            Measurement measurement;
+            for (int key : keys)
+            {
+                int value;
+                sink = sink + (indexed.TryFindValue(key, value) ? value : -1);
+            }
+            measurement.Report(ratio + " TryFindValue");
+        }
+    }
+}
+
+/// @brief A LinkedList used as a queue behind one mutex, the baseline for the concurrent queues.
+template <typename T>
+class MutexQueue
+{
+public:
+    void Append(const T &value)
+    {
+        lock_guard<mutex> guard(_lock);
+        _list.Append(value);
+    }
+
+    bool PopFront(T &value)
+    {
+        lock_guard<mutex> guard(_lock);
+        if (_list.Empty())
+        {
+            return false;
+        }
+        value = _list.Get(0);
+        _list.RemoveAt(0);
+        return true;
+    }
+
+private:
+    mutex _lock;
+    LinkedList<T> _list;
+};
+
+/// @brief Runs producers that append and consumers that pop until every value has been consumed.
+template <typename Queue>
+void BenchQueue(const string &label, int producers, int consumers, int perProducer)
+{
+    Queue queue;
+    atomic<int> consumed(0);
+    atomic<long long> sum(0);
+    const int total = producers * perProducer;
+
+    Measurement measurement;
+    vector<thread> threads;
+
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue, perProducer]()
+                             {
+                                 for (int i = 0; i < perProducer; i++)
+                                 {
+                                     queue.Append(i);
+                                 } });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&queue, &consumed, &sum, total]()
+                             {
+                                 int value;
+                                 long long localSum = 0;
+                                 while (consumed.load(memory_order_relaxed) < total)
+                                 {
+                                     if (queue.PopFront(value))
+                                     {
+                                         localSum += value;
+                                         consumed++;
+                                     }
+                                 }
+                                 sum += localSum; });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - measurement.Start()).count();
+    measurement.Report(label + " " + to_string(producers) + "P/" + to_string(consumers) + "C, " +
+                       to_string(static_cast<long long>(total / ms)) + " items/ms");
+}
+
+/// @brief Lock-free queue versus a LinkedList behind a mutex.
+void BenchConcurrentQueue()
+{
+    const int perProducer = 200000;
+
+    cout << "queue: each producer appends " << perProducer << " values" << endl;
+    for (int threads = 1; threads <= 4; threads *= 2)
+    {
+        BenchQueue<MutexQueue<int>>("mutex + LinkedList   ", threads, threads, perProducer);
+        BenchQueue<ConcurrentLinkedQueue<int>>("ConcurrentLinkedQueue", threads, threads, perProducer);
+    }
+}
+
+/// @brief One producer and one consumer: the wait-free list versus the general purpose queues.
+void BenchSpsc()
+{
+    const int count = 2000000;
+
+    cout << "spsc: one thread appends " << count << " values while another pops them" << endl;
+    BenchQueue<MutexQueue<int>>("mutex + LinkedList   ", 1, 1, count);
+    BenchQueue<ConcurrentLinkedQueue<int>>("ConcurrentLinkedQueue", 1, 1, count);
+    BenchQueue<SpscLinkedList<int>>("SpscLinkedList       ", 1, 1, count);
+}
+
+/// @brief A LinkedList behind one mutex, the baseline for the fine-grained list.
+template <typename T>
+class MutexList
+{
+public:
+    void Append(const T &value)
+    {
+        lock_guard<mutex> guard(_lock);
+        _list.Append(value);
+    }
+
+    void InsertAt(const T &value, int position)
+    {
+        lock_guard<mutex> guard(_lock);
+        _list.InsertAt(value, position);
+    }
+
+    void RemoveAt(int position)
+    {
+        lock_guard<mutex> guard(_lock);
+        _list.RemoveAt(position);
+    }
+
+    int Size()
+    {
+        lock_guard<mutex> guard(_lock);
+        return _list.Size();
+    }
+
+    template <typename Function>
+    void ForEach(Function func)
+    {
+        lock_guard<mutex> guard(_lock);
+        _list.ForEach(func);
+    }
+
+private:
+    mutex _lock;
+    LinkedList<T> _list;
+};
+
+/// @brief Each thread inserts and removes around its own region of one shared list.
+template <typename List>
+void BenchRegionEdits(const string &label, int threadCount, int count, int operationsPerThread)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    Measurement measurement;
+    vector<thread> threads;
+    const int region = count / threadCount;
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&list, t, region, operationsPerThread]()
+                             {
+                                 for (int i = 0; i < operationsPerThread; i++)
+                                 {
+                                     // Jump around inside the region so no walk can resume from the last one.
+                                     int position = t * region + (i * 37) % (region / 2);
+                                     if (i % 2 == 0)
+                                     {
+                                         list.InsertAt(i, position);
+                                     }
+                                     else
+                                     {
+                                         list.RemoveAt(position);
+                                     }
+                                 } });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    measurement.Report(label + " " + to_string(threadCount) + " thread(s)");
+}
+
+/// @brief Scaling of positional edits in disjoint regions with per-node locks versus one global lock.
+void BenchFineGrained()
+{
+    const int count = 4000;
+    const int operations = 4000;
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+
+    cout << "finegrained: " << operations << " InsertAt/RemoveAt per thread in its own region of " << count << " elements" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        BenchRegionEdits<MutexList<int>>("mutex + LinkedList   ", threads, count, operations);
+        BenchRegionEdits<FineGrainedLinkedList<int>>("FineGrainedLinkedList", threads, count, operations);
+    }
+}
+
+/// @brief Sequential ForEach/FindIndex/StableSort/AppendRange versus the parallel overloads on pools of growing size.
+void BenchParallel()
+{
+    const int count = 2000000;
+    LinkedList<int> list;
+    FillRandom(list, count);
+
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+    // Counts the rare elements that hash to 0, so the parallel version has almost no shared writes.
+    auto matches = [](int value)
+    {
+        return ((value * 2654435761u) >> 7) % 1000 == 0;
+    };
+
+    cout << "parallel: ForEach and FindIndex (match at the last element) over " << count << " elements" << endl;
+
+    volatile long long sink = 0;
+    {
+        Measurement measurement;
+        int hits = 0;
+        list.ForEach([&](const int &value)
+                     { hits += matches(value); });
+        sink = sink + hits;
+        measurement.Report("sequential ForEach  ");
+    }
+    {
+        list.Append(-1);
+        Measurement measurement;
+        sink = sink + list.FindIndex([](const int &value)
+                                     { return value == -1; });
+        measurement.Report("sequential FindIndex");
+    }
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+        {
+            Measurement measurement;
+            atomic<int> hits(0);
+            list.ForEach(pool, [&](const int &value)
+                         {
+                             if (matches(value))
+                             {
+                                 hits.fetch_add(1, memory_order_relaxed);
+                             } });
+            sink = sink + hits.load();
+            measurement.Report("parallel ForEach   " + to_string(threads) + " thread(s)");
+        }
+        {
+            Measurement measurement;
+            sink = sink + list.FindIndex(pool, [](const int &value)
+                                         { return value == -1; });
+            measurement.Report("parallel FindIndex " + to_string(threads) + " thread(s)");
+        }
+    }
+
+    cout << "parallel: StableSort and AppendRange of " << count << " random values" << endl;
+
+    vector<int> values(list.begin(), list.end());
+    {
+        LinkedList<int> sorted;
+        sorted.AppendRange(values.begin(), values.end());
+        Measurement measurement;
+        sorted.StableSort();
+        measurement.Report("sequential StableSort ");
+    }
+    {
+        LinkedList<int> loaded;
+        Measurement measurement;
+        loaded.AppendRange(values.begin(), values.end());
+        measurement.Report("sequential AppendRange");
+    }
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+        {
+            LinkedList<int> sorted;
+            sorted.AppendRange(values.begin(), values.end());
+            Measurement measurement;
+            sorted.ParallelSort(pool);
+            measurement.Report("ParallelSort          " + to_string(threads) + " thread(s)");
+        }
+        {
+            LinkedList<int> loaded;
+            Measurement measurement;
+            loaded.AppendRange(pool, values.begin(), values.end());
+            measurement.Report("parallel AppendRange  " + to_string(threads) + " thread(s)");
+        }
+    }
+}
+
+/// @brief Readers run ForEach over the whole list while one writer appends at the tail and removes at the head.
+template <typename List>
+void BenchReadersWithWriter(const string &label, int readerCount, int count, int writes)
+{
+    List list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i);
+    }
+
+    atomic<bool> done(false);
+    atomic<long long> passes(0);
+    vector<thread> readers;
+
+    Measurement measurement;
+    for (int r = 0; r < readerCount; r++)
+    {
+        readers.emplace_back([&list, &done, &passes]()
+                             {
+                                 long long sum = 0;
+                                 long long localPasses = 0;
+                                 while (!done.load())
+                                 {
+                                     list.ForEach([&sum](const int &value)
+                                                  { sum += value; });
+                                     localPasses++;
+                                 }
+                                 passes += localPasses + (sum == 42); });
+    }
+
+    for (int i = 0; i < writes; i++)
+    {
+        list.Append(count + i);
+        list.RemoveAt(0);
+    }
+    done = true;
+
+    for (thread &t : readers)
+    {
+        t.join();
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - measurement.Start()).count();
+    measurement.Report(label + " " + to_string(readerCount) + " reader(s), " +
+                       to_string(static_cast<long long>(passes.load() / ms * 1000)) + " passes/s, " +
+                       to_string(static_cast<long long>(writes / ms)) + " writes/ms");
+}
+
+/// @brief Lock-free snapshot readers versus readers that take the same mutex as the writer.
+void BenchSnapshot()
+{
+    const int count = 2000;
+    const int writes = 100000;
+
+    cout << "snapshot: " << writes << " Append + RemoveAt(0) by one writer while readers walk " << count << " elements" << endl;
+    for (int readers = 0; readers <= 4; readers = max(1, readers * 2))
+    {
+        BenchReadersWithWriter<MutexList<int>>("mutex + LinkedList", readers, count, writes);
+        BenchReadersWithWriter<SnapshotLinkedList<int>>("SnapshotLinkedList", readers, count, writes);
+    }
+}
+
+/// @brief An object that checks it is still alive whenever it is read.
+struct Checked
+{
+    static atomic<long> alive;
+    long magic;
+
+    Checked() : magic(0x600D)
+    {
+        alive++;
+    }
+
+    ~Checked()
+    {
+        magic = 0;
+        alive--;
+    }
+};
+
+atomic<long> Checked::alive(0);
+
+/// @brief Cost of pinning, and of retiring nodes compared to deleting them, then a stress run where
+/// threads keep replacing a shared object while others read it.
+void BenchReclaim()
+{
+    const int operations = 1000000;
+
+    cout << "reclaim: " << operations << " operations per measurement" << endl;
+    {
+        EpochReclaimer reclaimer;
+        Measurement measurement;
+        for (int i = 0; i < operations; i++)
+        {
+            EpochReclaimer::Guard guard = reclaimer.Pin();
+        }
+        measurement.Report("Pin + unpin        ");
+    }
+    {
+        Measurement measurement;
+        for (int i = 0; i < operations; i++)
+        {
+            delete new Checked();
+        }
+        measurement.Report("new + delete       ");
+    }
+    {
+        EpochReclaimer reclaimer;
+        Measurement measurement;
+        for (int i = 0; i < operations; i++)
+        {
+            EpochReclaimer::Guard guard = reclaimer.Pin();
+            reclaimer.Retire(new Checked());
+        }
+        measurement.Report("new + Retire       ");
+        cout << "  still pending: " << reclaimer.Pending() << endl;
+    }
+
+    int threadCount = max(4, static_cast<int>(thread::hardware_concurrency()));
+    const int perThread = operations / threadCount;
+    atomic<size_t> maxPending(0);
+    atomic<long> failures(0);
+    {
+        EpochReclaimer reclaimer;
+        atomic<Checked *> shared(new Checked());
+        vector<thread> threads;
+
+        Measurement measurement;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                                     for (int i = 0; i < perThread; i++)
+                                     {
+                                         EpochReclaimer::Guard guard = reclaimer.Pin();
+
+                                         if ((i + t) % 8 == 0)
+                                         {
+                                             reclaimer.Retire(shared.exchange(new Checked()));
+                                         }
+                                         else if (shared.load()->magic != 0x600D)
+                                         {
+                                             failures++;
+                                         }
+
+                                         if (i % 1024 == 0)
+                                         {
+                                             size_t pending = reclaimer.Pending();
+                                             size_t seen = maxPending.load();
+                                             while (pending > seen && !maxPending.compare_exchange_weak(seen, pending))
+                                             {
+                                             }
+                                         }
+                                     } });
+        }
+        for (thread &t : threads)
+        {
+            t.join();
+        }
+        measurement.Report("stress " + to_string(threadCount) + " threads  ");
+        delete shared.load();
+    }
+
+    cout << "  reads of freed objects: " << failures.load() << ", most garbage waiting: " << maxPending.load()
+         << ", objects leaked: " << Checked::alive.load() << endl;
+}
+
+/// @brief Every thread appends its own values to one shared list.
+template <typename List>
+void BenchConcurrentAppend(const string &label, List &list, int threadCount, int perThread)
+{
+    vector<thread> threads;
+
+    Measurement measurement;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&list, perThread]()
+                             {
+                                 for (int i = 0; i < perThread; i++)
+                                 {
+                                     list.Append(i);
+                                 } });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - measurement.Start()).count();
+    measurement.Report(label + " " + to_string(threadCount) + " thread(s), " +
+                       to_string(static_cast<long long>(threadCount * perThread / ms)) + " appends/ms");
+}
+
+/// @brief Every thread increments one shared counter.
+template <typename Counter>
+void BenchConcurrentIncrement(const string &label, Counter &counter, int threadCount, int perThread)
+{
+    vector<thread> threads;
+
+    Measurement measurement;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&counter, perThread]()
+                             {
+                                 for (int i = 0; i < perThread; i++)
+                                 {
+                                     counter.Increment();
+                                 } });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - measurement.Start()).count();
+    measurement.Report(label + " " + to_string(threadCount) + " thread(s), " +
+                       to_string(static_cast<long long>(threadCount * static_cast<double>(perThread) / ms)) + " increments/ms");
+}
+
+/// @brief Appends from many threads to per-thread shards versus one list behind a mutex, plus the cost of
+/// the merge the first read after them does.
+void BenchSharded()
+{
+    const int perThread = 500000;
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+
+    cout << "sharded: each thread appends " << perThread << " values" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        {
+            MutexList<int> list;
+            BenchConcurrentAppend("mutex + LinkedList", list, threads, perThread);
+        }
+        {
+            ShardedLinkedList<int> list(threads);
+            BenchConcurrentAppend("ShardedLinkedList ", list, threads, perThread);
+
+            Measurement measurement;
+            int size = 0;
+            list.ForEach([&size](const int &)
+                         { size++; });
+            measurement.Report("  merge + ForEach over " + to_string(size));
+        }
+    }
+}
+
+/// @brief One shared atomic size, updated by every insert like FineGrainedLinkedList used to.
+class AtomicSizeCounter
+{
+public:
+    AtomicSizeCounter() : _value(0) {}
+
+    void Increment()
+    {
+        _value++;
+    }
+
+    long Get(SizeMode mode = SizeMode::Exact) const
+    {
+        return _value.load();
+    }
+
+private:
+    atomic<long> _value;
+};
+
+/// @brief A sharded list that also keeps a size, to see what the counter costs once appends no longer
+/// share a tail.
+template <typename Counter>
+class CountedShardedList
+{
+public:
+    explicit CountedShardedList(int shards) : _list(shards) {}
+
+    void Append(int value)
+    {
+        _list.Append(value);
+        _size.Increment();
+    }
+
+    long Size(SizeMode mode = SizeMode::Exact) const
+    {
+        return _size.Get(mode);
+    }
+
+private:
+    ShardedLinkedList<int> _list;
+    Counter _size;
+};
+
+/// @brief Bare increments and sharded appends with one shared atomic size versus a StripedCounter, plus
+/// the cost of exact and approximate reads.
+void BenchCounter()
+{
+    const int perThread = 2000000;
+    const int appendsPerThread = 500000;
+    const int reads = 1000000;
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+
+    cout << "counter: each thread increments " << perThread << " times" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        {
+            AtomicSizeCounter counter;
+            BenchConcurrentIncrement("single atomic ", counter, threads, perThread);
+        }
+        {
+            StripedCounter counter;
+            BenchConcurrentIncrement("StripedCounter", counter, threads, perThread);
+        }
+    }
+
+    cout << "counter: each thread appends " << appendsPerThread << " values to a ShardedLinkedList that keeps a size" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        {
+            CountedShardedList<AtomicSizeCounter> list(threads);
+            BenchConcurrentAppend("single atomic ", list, threads, appendsPerThread);
+        }
+        {
+            CountedShardedList<StripedCounter> list(threads);
+            BenchConcurrentAppend("StripedCounter", list, threads, appendsPerThread);
+        }
+    }
+
+    cout << "counter: " << reads << " reads of a StripedCounter with " << StripedCounter().StripeCount() << " stripe(s)" << endl;
+    StripedCounter counter;
+    counter.Add(12345);
+    volatile long sink = 0;
+    {
+        Measurement measurement;
+        for (int i = 0; i < reads; i++)
+        {
+            sink = sink + counter.Get(SizeMode::Exact);
+        }
+        measurement.Report("Exact      ");
+    }
+    {
+        Measurement measurement;
+        for (int i = 0; i < reads; i++)
+        {
+            sink = sink + counter.Get(SizeMode::Approximate);
+        }
+        measurement.Report("Approximate");
+    }
+}
+
+/// @brief A named benchmark.
+struct Benchmark
+{
+    const char *name;
+    void (*function)();
+};
+
+static const Benchmark benchmarks[] = {
+    {"allocator", BenchAllocator},
+    {"unrolled", BenchUnrolled},
+    {"cursor", BenchCursor},
+    {"doubly", BenchDoubly},
+    {"move", BenchMove},
+    {"bulk", BenchBulkLoad},
+    {"splice", BenchSplice},
+    {"sort", BenchSort},
+    {"view", BenchView},
+    {"remove", BenchRemove},
+    {"indexed", BenchIndexed},
+    {"byvalue", BenchByValue},
+    {"try", BenchTry},
+    {"queue", BenchConcurrentQueue},
+    {"finegrained", BenchFineGrained},
+    {"parallel", BenchParallel},
+    {"spsc", BenchSpsc},
+    {"snapshot", BenchSnapshot},
+    {"reclaim", BenchReclaim},
+    {"sharded", BenchSharded},
+    {"counter", BenchCounter},
+    {"simd", BenchSimd},
+};
+
+int main(int argc, char *argv[])
+{
+    for (const Benchmark &benchmark : benchmarks)
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++)
+        {
+            selected = selected || benchmark.name == string(argv[i]);
+        }
+
+        if (selected)
+        {
+            benchmark.function();
+        }
+    }
+
+    return 0;
+}
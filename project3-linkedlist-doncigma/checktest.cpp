@@ -0,0 +1,1874 @@
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "checktest.hpp"
+#include "concurrentlinkedqueue.hpp"
+#include "doublylinkedlist.hpp"
+#include "finegrainedlinkedlist.hpp"
+#include "indexedlinkedlist.hpp"
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+#include "shardedlinkedlist.hpp"
+#include "simdsearch.hpp"
+#include "snapshotlinkedlist.hpp"
+#include "spsclinkedlist.hpp"
+#include "threadpool.hpp"
+#include "unrolledlinkedlist.hpp"
+
+using namespace std;
+
+bool TestCheck(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+
+vector<TestFunctionEntry> checkTestCommands = {
+    {"check", "check <structure> [seed] [operations] - runs a self-checking test and prints ok or the first mismatch", TestCheck},
+};
+
+/// @brief A self-checking test.  Returns false and describes the first mismatch in failure.
+typedef bool (*CheckFunction)(unsigned seed, int operations, string &failure);
+
+/// @brief Builds the description of a mismatch.
+/// @param step The number of the operation that went wrong, counting from 0
+/// @param operation The operation, such as "insertat 3"
+/// @param problem What was wrong
+static string Mismatch(int step, const string &operation, const string &problem)
+{
+    return "step " + to_string(step) + " (" + operation + "): " + problem;
+}
+
+/// @brief Checks what a list keeps besides the forward chain.  Nothing for most lists.
+template <typename List>
+static string CompareLinks(const List &, const vector<int> &)
+{
+    return "";
+}
+
+/// @brief Walks a DoublyLinkedList backwards, which checks every prev link and the tail.
+template <typename T, typename Allocator>
+static string CompareLinks(const DoublyLinkedList<T, Allocator> &list, const vector<int> &model)
+{
+    vector<int> walked;
+    list.ForEachReverse([&walked](const int &value)
+                        { walked.push_back(value); });
+    if (walked != vector<int>(model.rbegin(), model.rend()))
+    {
+        return "ForEachReverse visits " + to_string(walked.size()) + " elements that differ from the expected ones";
+    }
+    return "";
+}
+
+/// @brief Compares a list with the vector it should match: the size, every element through ForEach,
+/// every element through Get and, where the list has them, the backward links.
+/// @return An empty string if they match, otherwise what differs
+template <typename List>
+static string CompareWithModel(const List &list, const vector<int> &model)
+{
+    if (list.Size() != static_cast<int>(model.size()))
+    {
+        return "Size() is " + to_string(list.Size()) + ", expected " + to_string(model.size());
+    }
+    if (list.Empty() != model.empty())
+    {
+        return "Empty() is " + to_string(list.Empty()) + ", expected " + to_string(model.empty());
+    }
+
+    vector<int> walked;
+    list.ForEach([&walked](const int &value)
+                 { walked.push_back(value); });
+    if (walked != model)
+    {
+        return "ForEach visits " + to_string(walked.size()) + " elements that differ from the expected ones";
+    }
+
+    for (int i = 0; i < static_cast<int>(model.size()); i++)
+    {
+        if (list.Get(i) != model[i])
+        {
+            return "Get(" + to_string(i) + ") is " + to_string(list.Get(i)) + ", expected " + to_string(model[i]);
+        }
+    }
+    return CompareLinks(list, model);
+}
+
+/// @brief Checks that an edit or read at a bad position throws a LinkedListException.
+/// @return True if it threw
+template <typename Function>
+static bool Throws(Function func)
+{
+    try
+    {
+        func();
+    }
+    catch (const LinkedListException &)
+    {
+        return true;
+    }
+    return false;
+}
+
+/// @brief Runs random Append, Prepend, InsertAt, RemoveAt and Clear calls on a list and on a std::vector side
+/// by side, and compares the two after every call.  The size is kept between 0 and maxSize so both small
+/// and large lists are covered.  Every few calls a bad position is tried, which must throw and leave the
+/// list alone.
+/// @tparam List A list of int with the LinkedList interface
+template <typename List>
+static bool CheckAgainstVector(List &list, unsigned seed, int operations, int maxSize, string &failure)
+{
+    mt19937 random(seed);
+    vector<int> model;
+
+    for (int step = 0; step < operations; step++)
+    {
+        int size = static_cast<int>(model.size());
+        int value = static_cast<int>(random() % 1000);
+        int choice = static_cast<int>(random() % 100);
+        string operation;
+
+        // Grow while small, shrink while large, and wander in between.
+        bool grow = size < maxSize / 4 || (size < maxSize && choice < 55);
+
+        if (choice == 99)
+        {
+            int position = static_cast<int>(random() % 3) == 0 ? -1 : size + static_cast<int>(random() % 3);
+            operation = "bad position " + to_string(position);
+            if (!Throws([&]()
+                        { list.Get(position); }) ||
+                !Throws([&]()
+                        { list.RemoveAt(position); }) ||
+                !Throws([&]()
+                        { list.InsertAt(value, position < 0 ? position : size + 1); }))
+            {
+                failure = Mismatch(step, operation, "no LinkedListException");
+                return false;
+            }
+        }
+        else if (choice == 98 && size > 0)
+        {
+            operation = "clear";
+            list.Clear();
+            model.clear();
+        }
+        else if (grow && (size == 0 || choice % 3 == 0))
+        {
+            if (choice % 2 == 0)
+            {
+                operation = "append " + to_string(value);
+                list.Append(value);
+                model.push_back(value);
+            }
+            else
+            {
+                operation = "prepend " + to_string(value);
+                list.Prepend(value);
+                model.insert(model.begin(), value);
+            }
+        }
+        else if (grow)
+        {
+            int position = static_cast<int>(random() % (size + 1));
+            operation = "insertat " + to_string(value) + " " + to_string(position);
+            list.InsertAt(value, position);
+            model.insert(model.begin() + position, value);
+        }
+        else
+        {
+            int position = static_cast<int>(random() % size);
+            operation = "removeat " + to_string(position);
+            list.RemoveAt(position);
+            model.erase(model.begin() + position);
+        }
+
+        string problem = CompareWithModel(list, model);
+        if (!problem.empty())
+        {
+            failure = Mismatch(step, operation, problem);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief LinkedList itself, whose positional calls resume from a cursor left by the previous one.
+static bool CheckLinked(unsigned seed, int operations, string &failure)
+{
+    LinkedList<int> list;
+    return CheckAgainstVector(list, seed, operations, 300, failure);
+}
+
+/// @brief Several threads reading one list through const Get, Find and FindValue at the same time, which
+/// must not write to the list.  Every thread checks every value it reads.
+static bool CheckSharedReads(unsigned seed, int operations, string &failure)
+{
+    const int threadCount = 4;
+    const int count = 500;
+
+    LinkedList<int> list;
+    for (int i = 0; i < count; i++)
+    {
+        list.Append(i * 3);
+    }
+    const LinkedList<int> &shared = list;
+
+    atomic<int> mismatches(0);
+    vector<thread> readers;
+    for (int t = 0; t < threadCount; t++)
+    {
+        readers.emplace_back([&, t]()
+                             {
+                                 mt19937 random(seed + t);
+                                 for (int i = 0; i < operations; i++)
+                                 {
+                                     int position = static_cast<int>(random() % count);
+                                     int expected = position * 3;
+                                     if (shared.Get(position) != expected ||
+                                         shared.Find([expected](const int &value)
+                                                     { return value >= expected; }) != expected ||
+                                         shared.FindValue(expected) != expected)
+                                     {
+                                         mismatches++;
+                                     }
+                                 } });
+    }
+    for (thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    if (mismatches.load() > 0)
+    {
+        failure = to_string(mismatches.load()) + " reads returned the wrong element";
+        return false;
+    }
+    return true;
+}
+
+/// @brief The skip list of IndexedLinkedList.  Get on every position after every edit checks the spans.
+static bool CheckIndexed(unsigned seed, int operations, string &failure)
+{
+    IndexedLinkedList<int> list;
+    return CheckAgainstVector(list, seed, operations, 300, failure);
+}
+
+/// @brief DoublyLinkedList, whose Get, InsertAt and RemoveAt walk from the nearer end.  Get on every
+/// position crosses the midpoint both ways, and walking backwards checks the prev links.
+static bool CheckDoubly(unsigned seed, int operations, string &failure)
+{
+    DoublyLinkedList<int> list;
+    return CheckAgainstVector(list, seed, operations, 300, failure);
+}
+
+/// @brief Runs random InsertAfter, EraseAfter, Append and writes through iterators on a LinkedList and on a
+/// std::vector side by side.  After every call the list is compared through its iterators too.  Erasing
+/// the last element is followed by appends often enough to catch a stale tail.
+static bool CheckIterators(unsigned seed, int operations, string &failure)
+{
+    mt19937 random(seed);
+    LinkedList<int> list;
+    vector<int> model;
+
+    for (int step = 0; step < operations; step++)
+    {
+        int size = static_cast<int>(model.size());
+        int value = static_cast<int>(random() % 1000);
+        int choice = static_cast<int>(random() % 100);
+        string operation;
+
+        if (size == 0 || choice < 15)
+        {
+            operation = "append " + to_string(value);
+            list.Append(value);
+            model.push_back(value);
+        }
+        else if (choice < 20)
+        {
+            operation = "bad iterator";
+            LinkedList<int>::iterator last = list.begin();
+            advance(last, size - 1);
+            if (!Throws([&]()
+                        { list.InsertAfter(list.end(), value); }) ||
+                !Throws([&]()
+                        { list.EraseAfter(list.end()); }) ||
+                !Throws([&]()
+                        { list.EraseAfter(last); }))
+            {
+                failure = Mismatch(step, operation, "no LinkedListException");
+                return false;
+            }
+        }
+        else if (choice < 30)
+        {
+            int position = static_cast<int>(random() % size);
+            operation = "write " + to_string(value) + " at " + to_string(position);
+            LinkedList<int>::iterator element = list.begin();
+            advance(element, position);
+            *element = value;
+            model[position] = value;
+        }
+        else if (choice < 65 && size < 200)
+        {
+            int position = static_cast<int>(random() % size);
+            operation = "insertafter " + to_string(position) + " " + to_string(value);
+            LinkedList<int>::const_iterator element = list.cbegin();
+            advance(element, position);
+            LinkedList<int>::iterator inserted = list.InsertAfter(element, value);
+            model.insert(model.begin() + position + 1, value);
+            if (inserted == list.end() || *inserted != value)
+            {
+                failure = Mismatch(step, operation, "the returned iterator is not the new element");
+                return false;
+            }
+        }
+        else if (size >= 2)
+        {
+            // Erase the last element a quarter of the time.
+            int position = choice % 4 == 0 ? size - 2 : static_cast<int>(random() % (size - 1));
+            operation = "eraseafter " + to_string(position);
+            LinkedList<int>::const_iterator element = list.cbegin();
+            advance(element, position);
+            LinkedList<int>::iterator next = list.EraseAfter(element);
+            model.erase(model.begin() + position + 1);
+            bool atEnd = position + 1 == static_cast<int>(model.size());
+            if (atEnd ? next != list.end() : next == list.end() || *next != model[position + 1])
+            {
+                failure = Mismatch(step, operation, "the returned iterator is not the element after the erased one");
+                return false;
+            }
+        }
+        else
+        {
+            operation = "removeat 0";
+            list.RemoveAt(0);
+            model.erase(model.begin());
+        }
+
+        string problem = CompareWithModel(list, model);
+        if (problem.empty() && !equal(list.begin(), list.end(), model.begin()))
+        {
+            problem = "iterating from begin() to end() differs from the expected elements";
+        }
+        if (!problem.empty())
+        {
+            failure = Mismatch(step, operation, problem);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief A node type of its own, so no other code shares its pool while the check runs.
+struct PoolCheckNode
+{
+    PoolCheckNode *next;
+    long payload[3];
+};
+
+/// @brief Runs rounds of short-lived threads that each allocate and free a few thousand nodes.  The nodes a
+/// thread frees go back to the shared list when it exits, so after the first round no round may need a
+/// new block.
+static bool CheckPool(unsigned seed, int operations, string &failure)
+{
+    const int rounds = 20;
+    mt19937 random(seed);
+    size_t blocksAfterFirstRound = 0;
+
+    for (int round = 0; round < rounds; round++)
+    {
+        // The first round is the largest, so it leaves enough free nodes for every later one.
+        int count = round == 0 ? operations : operations / 2 + static_cast<int>(random() % (operations / 2 + 1));
+
+        thread worker([count]()
+                      {
+                          NodePool<PoolCheckNode> pool;
+                          vector<PoolCheckNode *> nodes;
+                          for (int i = 0; i < count; i++)
+                          {
+                              nodes.push_back(pool.allocate(1));
+                          }
+                          for (PoolCheckNode *node : nodes)
+                          {
+                              pool.deallocate(node, 1);
+                          } });
+        worker.join();
+
+        size_t blocks = NodePool<PoolCheckNode>::BlockCount();
+        if (round == 0)
+        {
+            blocksAfterFirstRound = blocks;
+        }
+        else if (blocks > blocksAfterFirstRound)
+        {
+            failure = Mismatch(round, "thread with " + to_string(count) + " nodes", "the pool grew from " + to_string(blocksAfterFirstRound) + " to " + to_string(blocks) + " blocks");
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief The nodes each TaggedAllocator tag has allocated and not freed yet
+static long taggedLive[3];
+
+/// @brief A stateful allocator.  Allocators with different tags compare unequal, and every tag counts its
+/// live nodes, so a node freed through a different tag than it came from shows up as a count below zero.
+template <typename T>
+class TaggedAllocator
+{
+public:
+    typedef T value_type;
+
+    TaggedAllocator() : tag(0) {}
+    explicit TaggedAllocator(int tag) : tag(tag) {}
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U> &other) : tag(other.tag) {}
+
+    T *allocate(std::size_t n)
+    {
+        taggedLive[tag] += static_cast<long>(n);
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        taggedLive[tag] -= static_cast<long>(n);
+        ::operator delete(p);
+    }
+
+    int tag; ///< Which allocator this is a copy of
+};
+
+template <typename T, typename U>
+bool operator==(const TaggedAllocator<T> &a, const TaggedAllocator<U> &b)
+{
+    return a.tag == b.tag;
+}
+
+template <typename T, typename U>
+bool operator!=(const TaggedAllocator<T> &a, const TaggedAllocator<U> &b)
+{
+    return a.tag != b.tag;
+}
+
+/// @brief Runs random SplitAt, SpliceAt and Splice calls between two lists with the same allocator and one
+/// with a different allocator, next to std::vectors.  The lists are compared after every call, a spliced
+/// list must be left empty, and at the end every tag must have freed exactly the nodes it allocated.
+static bool CheckSplice(unsigned seed, int operations, string &failure)
+{
+    typedef LinkedList<int, TaggedAllocator<int>> List;
+
+    taggedLive[0] = 0;
+    taggedLive[1] = 0;
+    taggedLive[2] = 0;
+    mt19937 random(seed);
+    {
+        // lists[0] and lists[1] share tag 1, lists[2] has tag 2.
+        List lists[3] = {List(TaggedAllocator<int>(1)), List(TaggedAllocator<int>(1)), List(TaggedAllocator<int>(2))};
+        vector<int> models[3];
+
+        for (int step = 0; step < operations; step++)
+        {
+            int target = static_cast<int>(random() % 3);
+            int source = (target + 1 + static_cast<int>(random() % 2)) % 3;
+            int choice = static_cast<int>(random() % 100);
+            List &list = lists[target];
+            vector<int> &model = models[target];
+            int size = static_cast<int>(model.size());
+            string operation;
+
+            if (choice < 40 || size == 0)
+            {
+                int count = static_cast<int>(random() % 8);
+                operation = "append " + to_string(count) + " values to list " + to_string(target);
+                for (int i = 0; i < count; i++)
+                {
+                    int value = static_cast<int>(random() % 1000);
+                    list.Append(value);
+                    model.push_back(value);
+                }
+            }
+            else if (choice < 70)
+            {
+                // Split off a tail and splice it back in somewhere else.
+                int splitAt = static_cast<int>(random() % (size + 1));
+                operation = "splitat " + to_string(splitAt) + " of list " + to_string(target);
+                List second = list.SplitAt(splitAt);
+                vector<int> secondModel(model.begin() + splitAt, model.end());
+                model.resize(splitAt);
+
+                string problem = CompareWithModel(list, model);
+                if (problem.empty())
+                {
+                    problem = CompareWithModel(second, secondModel);
+                }
+                if (!problem.empty())
+                {
+                    failure = Mismatch(step, operation, problem);
+                    return false;
+                }
+
+                int spliceAt = static_cast<int>(random() % (model.size() + 1));
+                operation += ", spliceat " + to_string(spliceAt);
+                list.SpliceAt(spliceAt, std::move(second));
+                model.insert(model.begin() + spliceAt, secondModel.begin(), secondModel.end());
+            }
+            else if (choice < 85)
+            {
+                int position = static_cast<int>(random() % (size + 1));
+                operation = "spliceat " + to_string(position) + " of list " + to_string(source) + " into list " + to_string(target);
+                lists[target].SpliceAt(position, std::move(lists[source]));
+                model.insert(model.begin() + position, models[source].begin(), models[source].end());
+                models[source].clear();
+            }
+            else if (choice < 95)
+            {
+                operation = "splice list " + to_string(source) + " onto list " + to_string(target);
+                lists[target].Splice(std::move(lists[source]));
+                model.insert(model.end(), models[source].begin(), models[source].end());
+                models[source].clear();
+            }
+            else
+            {
+                operation = "bad position";
+                if (!Throws([&]()
+                            { list.SplitAt(size + 1); }) ||
+                    !Throws([&]()
+                            { list.SpliceAt(-1, std::move(lists[source])); }))
+                {
+                    failure = Mismatch(step, operation, "no LinkedListException");
+                    return false;
+                }
+            }
+
+            // Keep the lists from growing without bound.
+            if (model.size() > 400)
+            {
+                list.Clear();
+                model.clear();
+            }
+
+            for (int i = 0; i < 3; i++)
+            {
+                string problem = CompareWithModel(lists[i], models[i]);
+                if (!problem.empty())
+                {
+                    failure = Mismatch(step, operation, "list " + to_string(i) + ": " + problem);
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (taggedLive[0] != 0 || taggedLive[1] != 0 || taggedLive[2] != 0)
+    {
+        failure = "nodes left over per allocator: " + to_string(taggedLive[0]) + ", " + to_string(taggedLive[1]) + ", " + to_string(taggedLive[2]);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Inserts and removes at every position of lists of every size up to a few nodes, so every chunk
+/// boundary gets a split and a merge.  Each list is built twice: by Append, which fills every node, and by
+/// inserting in the middle, which leaves nodes half full after splits.
+template <int N>
+static bool CheckChunkBoundaries(string &failure)
+{
+    for (int size = 1; size <= 3 * N + 1; size++)
+    {
+        for (int layout = 0; layout < 2; layout++)
+        {
+            for (int position = 0; position <= size; position++)
+            {
+                for (int remove = 0; remove < 2; remove++)
+                {
+                    if (remove && position == size)
+                    {
+                        continue;
+                    }
+
+                    UnrolledLinkedList<int, N> list;
+                    vector<int> model;
+                    for (int i = 0; i < size; i++)
+                    {
+                        if (layout == 0 || model.empty())
+                        {
+                            list.Append(i);
+                            model.push_back(i);
+                        }
+                        else
+                        {
+                            int middle = static_cast<int>(model.size()) / 2;
+                            list.InsertAt(i, middle);
+                            model.insert(model.begin() + middle, i);
+                        }
+                    }
+
+                    string operation = "size " + to_string(size) + (layout == 0 ? ", appended, " : ", inserted in the middle, ");
+                    if (remove)
+                    {
+                        operation += "removeat " + to_string(position);
+                        list.RemoveAt(position);
+                        model.erase(model.begin() + position);
+                    }
+                    else
+                    {
+                        operation += "insertat -1 " + to_string(position);
+                        list.InsertAt(-1, position);
+                        model.insert(model.begin() + position, -1);
+                    }
+
+                    string problem = CompareWithModel(list, model);
+                    if (!problem.empty())
+                    {
+                        failure = Mismatch(0, operation, problem);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief UnrolledLinkedList with 4 elements per node, where almost every edit splits or merges a node,
+/// and with the default 16.
+static bool CheckUnrolled(unsigned seed, int operations, string &failure)
+{
+    if (!CheckChunkBoundaries<4>(failure) || !CheckChunkBoundaries<16>(failure))
+    {
+        return false;
+    }
+
+    UnrolledLinkedList<int, 4> small;
+    UnrolledLinkedList<int> large;
+    return CheckAgainstVector(small, seed, operations, 60, failure) &&
+           CheckAgainstVector(large, seed, operations, 300, failure);
+}
+
+/// @brief The structures the check command knows, by name.
+/// @brief Writers appending to ShardedLinkedList while a reader merges with ForEach and counts with Size.
+/// Appends only ever add, so every Size must be at least the one before and at most the number of appends
+/// started after it.  At the end every element must be there once, with each writer's in order.
+static bool CheckSharded(unsigned seed, int operations, string &failure)
+{
+    const int writerCount = 3;
+
+    ShardedLinkedList<int> list(2);
+    atomic<int> started(0);
+    atomic<int> writersLeft(writerCount);
+
+    vector<thread> writers;
+    for (int w = 0; w < writerCount; w++)
+    {
+        writers.emplace_back([&, w]()
+                             {
+                                 for (int i = 0; i < operations; i++)
+                                 {
+                                     started++;
+                                     list.Append(w * operations + i);
+                                 }
+                                 writersLeft--; });
+    }
+
+    mt19937 random(seed);
+    int lastSize = 0;
+    int reads = 0;
+    string problem;
+    while (problem.empty() && (writersLeft.load() > 0 || reads == 0))
+    {
+        if (random() % 2 == 0)
+        {
+            // Merges every shard into the merged list, racing the Size calls below.
+            list.ForEach([](const int &) {});
+        }
+
+        int size = list.Size();
+        int begun = started.load();
+        if (size < lastSize || size > begun)
+        {
+            problem = "Size " + to_string(size) + " after " + to_string(lastSize) + " with " +
+                      to_string(begun) + " appends started";
+        }
+        lastSize = size;
+        reads++;
+    }
+    for (thread &writer : writers)
+    {
+        writer.join();
+    }
+    if (!problem.empty())
+    {
+        failure = Mismatch(reads, "size", problem);
+        return false;
+    }
+
+    LinkedList<int, NodePool<int>> all = list.TakeAll();
+    if (all.Size() != writerCount * operations || !list.Empty())
+    {
+        failure = "took " + to_string(all.Size()) + " of " + to_string(writerCount * operations) + " elements";
+        return false;
+    }
+
+    vector<int> next(writerCount, 0);
+    bool ordered = true;
+    all.ForEach([&](const int &value)
+                {
+                    int writer = value / operations;
+                    if (writer < 0 || writer >= writerCount || value % operations != next[writer])
+                    {
+                        ordered = false;
+                        return;
+                    }
+                    next[writer]++; });
+    if (!ordered)
+    {
+        failure = "a writer's elements are missing, repeated or out of order";
+        return false;
+    }
+    return true;
+}
+
+/// @brief Producers appending to a queue while consumers pop from it.  Every element must come out once,
+/// and each consumer must see the elements of each producer in the order they were appended.
+/// @tparam Queue A queue with Append, PopFront and Empty
+template <typename Queue>
+static bool CheckQueue(int producers, int consumers, unsigned seed, int operations, string &failure)
+{
+    Queue queue;
+    const int total = producers * operations;
+    atomic<int> producersLeft(producers);
+    vector<vector<int>> taken(consumers);
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]()
+                             {
+                                 mt19937 random(seed + p);
+                                 for (int i = 0; i < operations; i++)
+                                 {
+                                     queue.Append(p * operations + i);
+                                     if (random() % 64 == 0)
+                                     {
+                                         this_thread::yield();
+                                     }
+                                 }
+                                 producersLeft--; });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&, c]()
+                             {
+                                 int value;
+                                 while (true)
+                                 {
+                                     // Once every producer is done, a failed pop means the queue is empty.
+                                     bool producersDone = producersLeft.load() == 0;
+                                     if (queue.PopFront(value))
+                                     {
+                                         taken[c].push_back(value);
+                                     }
+                                     else if (producersDone)
+                                     {
+                                         break;
+                                     }
+                                     else
+                                     {
+                                         this_thread::yield();
+                                     }
+                                 } });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    vector<bool> seen(total, false);
+    int popped = 0;
+    for (int c = 0; c < consumers; c++)
+    {
+        vector<int> last(producers, -1);
+        for (int value : taken[c])
+        {
+            int producer = value / operations;
+            if (value < 0 || value >= total || seen[value])
+            {
+                failure = "consumer " + to_string(c) + " popped " + to_string(value) + ", which was not in the queue";
+                return false;
+            }
+            if (value % operations <= last[producer])
+            {
+                failure = "consumer " + to_string(c) + " popped " + to_string(value) + " after " +
+                          to_string(producer * operations + last[producer]);
+                return false;
+            }
+            seen[value] = true;
+            last[producer] = value % operations;
+            popped++;
+        }
+    }
+    if (popped != total)
+    {
+        failure = to_string(total - popped) + " of " + to_string(total) + " elements were never popped";
+        return false;
+    }
+
+    int value;
+    if (!queue.Empty() || queue.PopFront(value))
+    {
+        failure = "the queue is not empty after every element was popped";
+        return false;
+    }
+    return true;
+}
+
+/// @brief ConcurrentLinkedQueue with several producers and consumers, then Size after appends and pops.
+static bool CheckConcurrentQueue(unsigned seed, int operations, string &failure)
+{
+    if (!CheckQueue<ConcurrentLinkedQueue<int>>(3, 3, seed, operations, failure))
+    {
+        return false;
+    }
+
+    ConcurrentLinkedQueue<int> queue;
+    for (int i = 0; i < operations; i++)
+    {
+        queue.Append(i);
+    }
+    int value;
+    for (int i = 0; i < operations / 2; i++)
+    {
+        queue.PopFront(value);
+    }
+    if (queue.Size() != operations - operations / 2)
+    {
+        failure = "Size " + to_string(queue.Size()) + " after " + to_string(operations) + " appends and " +
+                  to_string(operations / 2) + " pops";
+        return false;
+    }
+    return true;
+}
+
+/// @brief Threads appending, prepending, inserting, removing and reading FineGrainedLinkedList at random
+/// positions.  Edits never reorder the elements already there, so whatever is left of one thread's
+/// appends must still be in order and its prepends in reverse order, and the list must hold exactly the
+/// elements added minus the ones removed.
+static bool CheckFineGrained(unsigned seed, int operations, string &failure)
+{
+    const int threadCount = 3;
+    const int initialCount = 100;
+    // Element i added by group g is g * stride + i.  Thread t appends as group 3t, prepends as 3t + 1 and
+    // inserts as 3t + 2.  The initial elements are appends of the last group.
+    const int stride = operations + initialCount;
+    const int groupCount = threadCount * 3 + 1;
+
+    FineGrainedLinkedList<int> list;
+    for (int i = 0; i < initialCount; i++)
+    {
+        list.Append((groupCount - 1) * stride + i);
+    }
+
+    atomic<int> added(initialCount);
+    atomic<int> removed(0);
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]()
+                             {
+                                 mt19937 random(seed + t);
+                                 for (int i = 0; i < operations; i++)
+                                 {
+                                     int position = static_cast<int>(random() % (initialCount * 2));
+                                     try
+                                     {
+                                         switch (random() % 6)
+                                         {
+                                         case 0:
+                                             list.Append(3 * t * stride + i);
+                                             added++;
+                                             break;
+                                         case 1:
+                                             list.Prepend((3 * t + 1) * stride + i);
+                                             added++;
+                                             break;
+                                         case 2:
+                                             list.InsertAt((3 * t + 2) * stride + i, position);
+                                             added++;
+                                             break;
+                                         case 3:
+                                         case 4:
+                                             list.RemoveAt(position);
+                                             removed++;
+                                             break;
+                                         default:
+                                             list.Get(position);
+                                             break;
+                                         }
+                                     }
+                                     catch (const LinkedListException &)
+                                     {
+                                         // The list was shorter than the position when the walk got there.
+                                     }
+                                 } });
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    int expected = added.load() - removed.load();
+    vector<bool> seen(groupCount * stride, false);
+    vector<int> last(groupCount, -1);
+    int count = 0;
+    string problem;
+    list.ForEach([&](const int &value)
+                 {
+                     count++;
+                     if (!problem.empty())
+                     {
+                         return;
+                     }
+                     int group = value / stride;
+                     int index = value % stride;
+                     if (value < 0 || value >= groupCount * stride || seen[value])
+                     {
+                         problem = "element " + to_string(value) + " was never added or is there twice";
+                         return;
+                     }
+                     seen[value] = true;
+                     bool prepended = group % 3 == 1 && group != groupCount - 1;
+                     bool appended = group % 3 == 0 || group == groupCount - 1;
+                     if (last[group] >= 0 && ((appended && index < last[group]) || (prepended && index > last[group])))
+                     {
+                         problem = "element " + to_string(value) + " is out of order";
+                     }
+                     last[group] = index; });
+
+    if (problem.empty() && (count != expected || list.Size() != expected))
+    {
+        problem = to_string(count) + " elements and Size " + to_string(list.Size()) + " after " +
+                  to_string(added.load()) + " adds and " + to_string(removed.load()) + " removes";
+    }
+    if (!problem.empty())
+    {
+        failure = problem;
+        return false;
+    }
+    return true;
+}
+
+/// @brief SpscLinkedList with one producer and one consumer, first with ints and then with strings, whose
+/// nodes the producer recycles once the consumer has moved the values out.
+static bool CheckSpsc(unsigned seed, int operations, string &failure)
+{
+    if (!CheckQueue<SpscLinkedList<int>>(1, 1, seed, operations, failure))
+    {
+        return false;
+    }
+
+    SpscLinkedList<string> list;
+    atomic<bool> producerDone(false);
+    int popped = 0;
+    string problem;
+    thread consumer([&]()
+                    {
+                        string value;
+                        while (true)
+                        {
+                            bool done = producerDone.load();
+                            if (!list.PopFront(value))
+                            {
+                                if (done)
+                                {
+                                    break;
+                                }
+                                this_thread::yield();
+                                continue;
+                            }
+                            if (problem.empty() && value != "value " + to_string(popped))
+                            {
+                                problem = Mismatch(popped, "popfront", "got \"" + value + "\"");
+                            }
+                            popped++;
+                        } });
+
+    // Appends in bursts, so the producer alternates between allocating and reusing popped nodes.
+    mt19937 random(seed);
+    for (int i = 0; i < operations; i++)
+    {
+        list.Append("value " + to_string(i));
+        if (random() % 32 == 0)
+        {
+            this_thread::yield();
+        }
+    }
+    producerDone = true;
+    consumer.join();
+
+    if (problem.empty() && popped != operations)
+    {
+        problem = to_string(popped) + " of " + to_string(operations) + " elements were popped";
+    }
+    if (!problem.empty())
+    {
+        failure = problem;
+        return false;
+    }
+    return true;
+}
+
+/// @brief Hashes a sequence of elements, so a reader can record what it saw without copying it.
+static unsigned long long HashElements(const vector<int> &elements)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int element : elements)
+    {
+        hash = (hash ^ static_cast<unsigned>(element)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// @brief A writer editing SnapshotLinkedList while readers walk snapshots.  The writer records the
+/// contents at the version of every change.  Each snapshot must show exactly the contents of the latest
+/// change at or before its version, every time it is walked, however much the writer changed meanwhile.
+static bool CheckSnapshot(unsigned seed, int operations, string &failure)
+{
+    const int readerCount = 2;
+
+    SnapshotLinkedList<int> list;
+    map<uint64_t, unsigned long long> history = {{list.Read().Version(), HashElements(vector<int>())}};
+    atomic<bool> writerDone(false);
+    vector<vector<pair<uint64_t, unsigned long long>>> seen(readerCount);
+    vector<string> problems(readerCount);
+
+    vector<thread> readers;
+    for (int r = 0; r < readerCount; r++)
+    {
+        readers.emplace_back([&, r]()
+                             {
+                                 while (!writerDone.load() && problems[r].empty())
+                                 {
+                                     SnapshotLinkedList<int>::Snapshot snapshot = list.Read();
+                                     vector<int> first;
+                                     snapshot.ForEach([&first](const int &value)
+                                                      { first.push_back(value); });
+                                     this_thread::yield();
+
+                                     vector<int> second;
+                                     snapshot.ForEach([&second](const int &value)
+                                                      { second.push_back(value); });
+                                     if (first != second || snapshot.Size() != static_cast<int>(first.size()) ||
+                                         (!first.empty() && snapshot.Get(static_cast<int>(first.size()) - 1) != first.back()))
+                                     {
+                                         problems[r] = "snapshot " + to_string(snapshot.Version()) + " changed while it was held";
+                                     }
+                                     seen[r].push_back(make_pair(snapshot.Version(), HashElements(first)));
+                                 } });
+    }
+
+    mt19937 random(seed);
+    vector<int> model;
+    int next = 0;
+    for (int i = 0; i < operations; i++)
+    {
+        uint64_t version = list.Read().Version() + 1;
+        int choice = static_cast<int>(random() % 100);
+
+        if (model.empty() || (choice < 55 && model.size() < 64))
+        {
+            list.Append(next);
+            model.push_back(next++);
+        }
+        else if (choice < 99)
+        {
+            int position = static_cast<int>(random() % model.size());
+            list.RemoveAt(position);
+            model.erase(model.begin() + position);
+        }
+        else
+        {
+            list.Clear();
+            model.clear();
+        }
+        history[version] = HashElements(model);
+    }
+    writerDone = true;
+    for (thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    for (int r = 0; r < readerCount; r++)
+    {
+        if (!problems[r].empty())
+        {
+            failure = problems[r];
+            return false;
+        }
+        for (const pair<uint64_t, unsigned long long> &snapshot : seen[r])
+        {
+            // Versions published by reclamation alone change nothing, so they show the change before them.
+            map<uint64_t, unsigned long long>::const_iterator change = history.upper_bound(snapshot.first);
+            --change;
+            if (change->second != snapshot.second)
+            {
+                failure = "snapshot " + to_string(snapshot.first) + " does not match the list at change " +
+                          to_string(change->first);
+                return false;
+            }
+        }
+    }
+
+    vector<int> contents;
+    list.ForEach([&contents](const int &value)
+                 { contents.push_back(value); });
+    if (contents != model || list.Size() != static_cast<int>(model.size()))
+    {
+        failure = "the list does not match the writer's " + to_string(model.size()) + " elements";
+        return false;
+    }
+    return true;
+}
+
+/// @brief SimdSearch<T> against a plain loop, over runs of every length up to several registers and at
+/// every offset within a register, so both the vector kernels and the scalar tails are compared.
+/// @param name The type, for the failure message
+/// @param alphabet The values to fill runs with.  Few, so most runs have several matches.
+template <typename T>
+static bool CheckSimdType(const char *name, const vector<T> &alphabet, mt19937 &random, int operations,
+                          string &failure)
+{
+    const int maxCount = 100;
+    const int maxOffset = 8;
+    vector<T> buffer(maxCount + maxOffset);
+
+    for (int i = 0; i < operations + maxCount; i++)
+    {
+        // First every length with one match in the last element, then random lengths, offsets and values.
+        bool sweep = i < maxCount;
+        int count = sweep ? i : static_cast<int>(random() % (maxCount + 1));
+        int offset = sweep ? 0 : static_cast<int>(random() % maxOffset);
+        const T &value = alphabet[sweep ? 0 : random() % alphabet.size()];
+        const T *items = buffer.data() + offset;
+
+        for (int j = 0; j < count; j++)
+        {
+            buffer[offset + j] = alphabet[1 + random() % (alphabet.size() - 1)];
+            if (!sweep && random() % 4 == 0)
+            {
+                buffer[offset + j] = alphabet[random() % alphabet.size()];
+            }
+        }
+        if (sweep && count > 0)
+        {
+            buffer[offset + count - 1] = value;
+        }
+
+        int first = -1;
+        int matches = 0;
+        for (int j = count - 1; j >= 0; j--)
+        {
+            if (items[j] == value)
+            {
+                first = j;
+                matches++;
+            }
+        }
+
+        int foundFirst = SimdSearch<T>::FindFirst(items, count, value);
+        int foundMatches = SimdSearch<T>::Count(items, count, value);
+        if (foundFirst != first || foundMatches != matches)
+        {
+            failure = string(name) + " (" + SimdInstructionSet() + ") over " + to_string(count) +
+                      " elements at offset " + to_string(offset) + ": FindFirst " + to_string(foundFirst) +
+                      " and Count " + to_string(foundMatches) + ", expected " + to_string(first) + " and " +
+                      to_string(matches);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief SimdSearch for 1, 2, 4 and 8 byte integers and both floating point types.  The floating point
+/// values include 0 and -0, which compare equal, and NaN, which equals nothing.
+static bool CheckSimd(unsigned seed, int operations, string &failure)
+{
+    mt19937 random(seed);
+    const double nan = numeric_limits<double>::quiet_NaN();
+
+    return CheckSimdType<int8_t>("int8_t", {-128, 0, 1, -1, 127}, random, operations, failure) &&
+           CheckSimdType<uint8_t>("uint8_t", {255, 0, 1, 128}, random, operations, failure) &&
+           CheckSimdType<int16_t>("int16_t", {-32768, 0, 255, 256, -1}, random, operations, failure) &&
+           CheckSimdType<int32_t>("int32_t", {1 << 16, 0, 1, -1, 65535}, random, operations, failure) &&
+           CheckSimdType<int64_t>("int64_t", {1LL << 32, 0, 1, -1, 0xFFFFFFFFLL}, random, operations, failure) &&
+           CheckSimdType<float>("float", {-0.0f, 0.0f, 1.5f, static_cast<float>(nan)}, random, operations, failure) &&
+           CheckSimdType<float>("float", {1.5f, 0.0f, static_cast<float>(nan)}, random, operations, failure) &&
+           CheckSimdType<double>("double", {-0.0, 0.0, 1e300, nan}, random, operations, failure) &&
+           CheckSimdType<double>("double", {nan, 0.0, 1.0}, random, operations, failure);
+}
+
+/// @brief ListView pipelines against the same stages done by hand on a std::vector.  Counts the calls to
+/// each stage to make sure Take ends the walk as soon as it has its values, and Take(0) never starts it.
+static bool CheckView(unsigned seed, int operations, string &failure)
+{
+    mt19937 random(seed);
+
+    for (int step = 0; step < operations; step++)
+    {
+        LinkedList<int> list;
+        vector<int> model;
+        int size = static_cast<int>(random() % 40);
+        for (int i = 0; i < size; i++)
+        {
+            list.Append(static_cast<int>(random() % 20) - 10);
+            model.push_back(list.Get(i));
+        }
+        int divisor = 1 + static_cast<int>(random() % 3);
+        int count = static_cast<int>(random() % 12);
+
+        // Filter to multiples of divisor, keep count of them and turn them into strings.
+        vector<string> expected;
+        int expectedTests = 0;
+        for (int i = 0; i < size && static_cast<int>(expected.size()) < count; i++)
+        {
+            expectedTests++;
+            if (model[i] % divisor == 0)
+            {
+                expected.push_back("<" + to_string(model[i]) + ">");
+            }
+        }
+
+        int tests = 0;
+        int maps = 0;
+        LinkedList<string> collected;
+        list.View()
+            .Filter([&tests, divisor](int value)
+                    { tests++; return value % divisor == 0; })
+            .Take(count)
+            .Map([&maps](int value)
+                 { maps++; return "<" + to_string(value) + ">"; })
+            .CollectInto(collected);
+
+        vector<string> actual;
+        collected.ForEach([&actual](const string &value)
+                          { actual.push_back(value); });
+        if (actual != expected)
+        {
+            failure = Mismatch(step, "collectinto", "collected " + to_string(actual.size()) + " strings, expected " +
+                                                        to_string(expected.size()));
+            return false;
+        }
+        if (tests != expectedTests || maps != static_cast<int>(expected.size()))
+        {
+            failure = Mismatch(step, "take " + to_string(count), "the filter ran " + to_string(tests) +
+                                                                    " times and the map " + to_string(maps) +
+                                                                    ", expected " + to_string(expectedTests) +
+                                                                    " and " + to_string(expected.size()));
+            return false;
+        }
+
+        // Map to another type before Take, and fold the result.
+        double halves = list.View()
+                            .Map([](int value)
+                                 { return value / 2.0; })
+                            .Take(count)
+                            .Reduce(0.0, [](double total, double value)
+                                    { return total + value; });
+        double expectedHalves = 0;
+        for (int i = 0; i < size && i < count; i++)
+        {
+            expectedHalves += model[i] / 2.0;
+        }
+        if (halves != expectedHalves)
+        {
+            failure = Mismatch(step, "map", "the halves of the first " + to_string(count) + " elements add up to " +
+                                                to_string(halves) + ", expected " + to_string(expectedHalves));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief An element that counts its live copies and whose copy throws on one chosen value, from any thread.
+struct CountedElement
+{
+    static atomic<long> live;    ///< Elements constructed and not destroyed yet
+    static atomic<int> throwOn;  ///< The value whose copy throws, or -1
+
+    int value;
+
+    explicit CountedElement(int v) : value(v) { live++; }
+    CountedElement(const CountedElement &other) : value(other.value)
+    {
+        if (value == throwOn.load())
+        {
+            throw runtime_error("copy of " + to_string(value));
+        }
+        live++;
+    }
+    CountedElement &operator=(const CountedElement &) = default;
+    ~CountedElement() { live--; }
+};
+
+atomic<long> CountedElement::live(0);
+atomic<int> CountedElement::throwOn(-1);
+
+/// @brief The blocks handed out by every TrackingAllocator, shared by all threads.
+struct AllocationTracker
+{
+    static mutex lock;
+    static set<void *> live;      ///< Allocated and not freed yet
+    static vector<void *> freed;  ///< Freed, but kept until Release so a second free can be seen
+    static long doubleFrees;      ///< Frees of blocks that were not live
+
+    /// @brief Returns the freed blocks to the heap.  Only while no allocator is in use.
+    static void Release()
+    {
+        for (void *p : freed)
+        {
+            ::operator delete(p);
+        }
+        freed.clear();
+    }
+};
+
+mutex AllocationTracker::lock;
+set<void *> AllocationTracker::live;
+vector<void *> AllocationTracker::freed;
+long AllocationTracker::doubleFrees = 0;
+
+/// @brief A heap allocator that records every live block and holds on to freed ones, so a node freed twice
+/// is counted instead of corrupting the heap, and a leaked node is still live at the end.
+template <typename T>
+class TrackingAllocator
+{
+public:
+    typedef T value_type;
+
+    TrackingAllocator() {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U> &) {}
+
+    T *allocate(std::size_t n)
+    {
+        T *p = static_cast<T *>(::operator new(n * sizeof(T)));
+        lock_guard<mutex> guard(AllocationTracker::lock);
+        AllocationTracker::live.insert(p);
+        return p;
+    }
+
+    void deallocate(T *p, std::size_t)
+    {
+        lock_guard<mutex> guard(AllocationTracker::lock);
+        if (AllocationTracker::live.erase(p) == 0)
+        {
+            AllocationTracker::doubleFrees++;
+            return;
+        }
+        AllocationTracker::freed.push_back(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const TrackingAllocator<T> &, const TrackingAllocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const TrackingAllocator<T> &, const TrackingAllocator<U> &)
+{
+    return false;
+}
+
+/// @brief AppendRange on a thread pool, with ranges of several chunks appended to lists that already hold
+/// a few elements.  In some rounds the copy of one element throws, which must leave the list as it was
+/// and free every node built by every chunk exactly once: no node may be freed twice, and the nodes and
+/// elements alive must come back to what they were.  Runs one round per 100 operations.
+static bool CheckAppendRange(unsigned seed, int operations, string &failure)
+{
+    ThreadPool pool(3);
+    mt19937 random(seed);
+
+    for (int round = 0; round <= operations / 100; round++)
+    {
+        AllocationTracker::Release();
+        int count = 2049 + static_cast<int>(random() % 8000);
+        int before = static_cast<int>(random() % 4);
+        bool throws = random() % 2 == 0;
+
+        vector<CountedElement> source;
+        source.reserve(count);
+        for (int i = 0; i < count; i++)
+        {
+            source.emplace_back(i);
+        }
+
+        LinkedList<CountedElement, TrackingAllocator<CountedElement>> list;
+        for (int i = 0; i < before; i++)
+        {
+            list.Append(CountedElement(-2 - i));
+        }
+
+        long liveBefore = CountedElement::live.load();
+        size_t nodesBefore = AllocationTracker::live.size();
+        CountedElement::throwOn = throws ? static_cast<int>(random() % count) : -1;
+        bool threw = false;
+        try
+        {
+            list.AppendRange(pool, source.begin(), source.end());
+        }
+        catch (const runtime_error &)
+        {
+            threw = true;
+        }
+        CountedElement::throwOn = -1;
+
+        if (threw != throws)
+        {
+            failure = Mismatch(round, "appendrange", throws ? "no copy threw" : "a copy threw");
+            return false;
+        }
+
+        if (AllocationTracker::doubleFrees != 0)
+        {
+            failure = Mismatch(round, "appendrange", to_string(AllocationTracker::doubleFrees) + " nodes freed twice");
+            AllocationTracker::doubleFrees = 0;
+            CountedElement::live = 0;
+            return false;
+        }
+
+        int expectedSize = before + (throws ? 0 : count);
+        long expectedLive = liveBefore + (throws ? 0 : count);
+        size_t expectedNodes = nodesBefore + (throws ? 0 : count);
+        if (list.Size() != expectedSize || CountedElement::live.load() != expectedLive ||
+            AllocationTracker::live.size() != expectedNodes)
+        {
+            failure = Mismatch(round, "appendrange", "size " + to_string(list.Size()) + " and " +
+                                                         to_string(CountedElement::live.load() - liveBefore) +
+                                                         " new elements and " +
+                                                         to_string(AllocationTracker::live.size() - nodesBefore) +
+                                                         " new nodes alive after appending " + to_string(count) +
+                                                         (throws ? " with a throwing copy" : ""));
+            return false;
+        }
+
+        int position = 0;
+        bool ordered = true;
+        list.ForEach([&](const CountedElement &element)
+                     {
+                         int expected = position < before ? -2 - position : position - before;
+                         ordered = ordered && element.value == expected;
+                         position++; });
+        if (!ordered)
+        {
+            failure = Mismatch(round, "appendrange", "the elements are out of order");
+            return false;
+        }
+    }
+
+    AllocationTracker::Release();
+    if (CountedElement::live.load() != 0 || !AllocationTracker::live.empty())
+    {
+        failure = to_string(CountedElement::live.load()) + " elements and " +
+                  to_string(AllocationTracker::live.size()) + " nodes left alive after every list was destroyed";
+        return false;
+    }
+    return true;
+}
+
+/// @brief UnrolledLinkedList with 4 elements per node, where random Append, Prepend and InsertAt calls copy
+/// an element that throws.  A failed insert must leave the elements as they were and must not link a new
+/// node: Append and Prepend keep the node count, and InsertAt may only keep the node its split added.
+/// After every step no node may be empty, so there are never more nodes than elements.
+static bool CheckUnrolledThrows(unsigned seed, int operations, string &failure)
+{
+    enum Insert { Append, Prepend, InsertAt };
+    const int throwing = -7;
+
+    mt19937 random(seed);
+    {
+        UnrolledLinkedList<CountedElement, 4, TrackingAllocator<CountedElement>> list;
+        vector<int> model;
+
+        for (int step = 0; step < operations; step++)
+        {
+            int size = static_cast<int>(model.size());
+            int op = static_cast<int>(random() % 4);
+            string operation;
+
+            if (op == 3 && size > 20)
+            {
+                int position = static_cast<int>(random() % size);
+                operation = "removeat " + to_string(position);
+                list.RemoveAt(position);
+                model.erase(model.begin() + position);
+            }
+            else
+            {
+                Insert insert = size == 0 ? Append : op == 0 ? Append : op == 1 ? Prepend : InsertAt;
+                bool throws = random() % 3 == 0;
+                int value = throws ? throwing : step;
+                int position = insert == Append ? size : insert == Prepend ? 0 : static_cast<int>(random() % (size + 1));
+                size_t nodesBefore = AllocationTracker::live.size();
+                bool threw = false;
+
+                operation = insert == Append    ? "append " + to_string(value)
+                            : insert == Prepend ? "prepend " + to_string(value)
+                                                : "insertat " + to_string(value) + " " + to_string(position);
+
+                CountedElement::throwOn = throwing;
+                try
+                {
+                    if (insert == Append)
+                    {
+                        list.Append(CountedElement(value));
+                    }
+                    else if (insert == Prepend)
+                    {
+                        list.Prepend(CountedElement(value));
+                    }
+                    else
+                    {
+                        list.InsertAt(CountedElement(value), position);
+                    }
+                }
+                catch (const runtime_error &)
+                {
+                    threw = true;
+                }
+                CountedElement::throwOn = -1;
+
+                if (threw != throws)
+                {
+                    failure = Mismatch(step, operation, threw ? "threw" : "did not throw");
+                    return false;
+                }
+                if (!throws)
+                {
+                    model.insert(model.begin() + position, value);
+                }
+                else if (AllocationTracker::live.size() > nodesBefore + (insert == InsertAt ? 1 : 0))
+                {
+                    failure = Mismatch(step, operation, "a failed insert left " +
+                                                            to_string(AllocationTracker::live.size() - nodesBefore) +
+                                                            " new nodes");
+                    return false;
+                }
+            }
+
+            string problem;
+            if (list.Size() != static_cast<int>(model.size()))
+            {
+                problem = "Size " + to_string(list.Size()) + ", expected " + to_string(model.size());
+            }
+            else if (AllocationTracker::live.size() > model.size())
+            {
+                problem = to_string(AllocationTracker::live.size()) + " nodes for " + to_string(model.size()) + " elements";
+            }
+            for (int i = 0; problem.empty() && i < static_cast<int>(model.size()); i++)
+            {
+                if (list.Get(i).value != model[i])
+                {
+                    problem = "Get(" + to_string(i) + ") is " + to_string(list.Get(i).value) + ", expected " + to_string(model[i]);
+                }
+            }
+            if (!problem.empty())
+            {
+                failure = Mismatch(step, operation, problem);
+                return false;
+            }
+        }
+    }
+
+    AllocationTracker::Release();
+    if (CountedElement::live.load() != 0 || !AllocationTracker::live.empty())
+    {
+        failure = to_string(CountedElement::live.load()) + " elements and " +
+                  to_string(AllocationTracker::live.size()) + " nodes left alive after the list was destroyed";
+        return false;
+    }
+    return true;
+}
+
+/// @brief FineGrainedLinkedList walks whose predicate, function or element copy throws partway, each
+/// followed by edits and reads that pass the node it stopped on.  A lock left held would deadlock them,
+/// so the walks run on a thread of their own.  No progress for a few seconds counts as a deadlock, which
+/// ends the process with a failure status, since the blocked thread can never be joined.
+static bool CheckFineGrainedThrows(unsigned seed, int operations, string &failure)
+{
+    const int size = 50;
+
+    FineGrainedLinkedList<CountedElement> fineGrained;
+    vector<int> values;
+    for (int i = 0; i < size; i++)
+    {
+        fineGrained.Append(CountedElement(i));
+        values.push_back(i);
+    }
+
+    atomic<int> progress(0);
+    atomic<bool> done(false);
+    string message;
+    thread worker([&]()
+                  {
+                      mt19937 random(seed);
+                      for (int step = 0; step < operations && message.empty(); step++)
+                      {
+                          int position = static_cast<int>(random() % values.size());
+                          int value = values[position];
+                          bool threw = false;
+                          try
+                          {
+                              switch (random() % 3)
+                              {
+                              case 0:
+                                  fineGrained.FindIndex([value](const CountedElement &element) -> bool
+                                                  {
+                                                      if (element.value == value)
+                                                      {
+                                                          throw runtime_error("predicate");
+                                                      }
+                                                      return false; });
+                                  break;
+                              case 1:
+                                  fineGrained.ForEach([value](const CountedElement &element)
+                                                {
+                                                    if (element.value == value)
+                                                    {
+                                                        throw runtime_error("function");
+                                                    }
+                                                });
+                                  break;
+                              default:
+                                  CountedElement::throwOn = value;
+                                  fineGrained.Get(position);
+                                  break;
+                              }
+                          }
+                          catch (const runtime_error &)
+                          {
+                              threw = true;
+                          }
+                          CountedElement::throwOn = -1;
+                          if (!threw)
+                          {
+                              message = Mismatch(step, "throw", "the walk did not throw at " + to_string(value));
+                              break;
+                          }
+
+                          // Edits and reads past the node the walk stopped on.
+                          int added = size + step;
+                          fineGrained.InsertAt(CountedElement(added), position);
+                          values.insert(values.begin() + position, added);
+                          fineGrained.RemoveAt(position + 1);
+                          values.erase(values.begin() + position + 1);
+                          fineGrained.Append(CountedElement(-5));
+                          fineGrained.RemoveAt(static_cast<int>(values.size()));
+                          if (fineGrained.Get(static_cast<int>(values.size()) - 1).value != values.back())
+                          {
+                              message = Mismatch(step, "get", "the last element is wrong after the edits");
+                          }
+                          progress++;
+                      }
+                      done = true; });
+
+    int lastProgress = -1;
+    int idleChecks = 0;
+    while (!done.load())
+    {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        int current = progress.load();
+        idleChecks = current == lastProgress ? idleChecks + 1 : 0;
+        lastProgress = current;
+        if (idleChecks == 50)
+        {
+            cerr << Mismatch(current, "edit", "deadlocked after a walk threw") << endl;
+            _Exit(EXIT_FAILURE);
+        }
+    }
+    worker.join();
+
+    if (!message.empty())
+    {
+        failure = message;
+        return false;
+    }
+
+    vector<int> contents;
+    fineGrained.ForEach([&contents](const CountedElement &element)
+                        { contents.push_back(element.value); });
+    if (contents != values || fineGrained.Size() != static_cast<int>(values.size()))
+    {
+        failure = "the list does not match the model after the walks that threw";
+        return false;
+    }
+    return true;
+}
+
+/// @brief The parallel ForEach, Find and FindIndex of LinkedList on lists of several chunks.  With three
+/// threads and up to 12288 elements every chunk holds 1024 elements, so matches are placed on both sides
+/// of chunk edges.  The searches must return the same element as the sequential ones, and ForEach must
+/// visit every element exactly once.
+static bool CheckParallelSearch(unsigned seed, int operations, string &failure)
+{
+    const int chunkSize = 1024;
+    ThreadPool pool(3);
+    mt19937 random(seed);
+
+    for (int round = 0; round <= operations / 100; round++)
+    {
+        int size = 2049 + static_cast<int>(random() % 10000);
+        LinkedList<int> list;
+        for (int i = 0; i < size; i++)
+        {
+            list.Append(i);
+        }
+
+        // Elements are their own positions, so a match is marked by position.
+        vector<char> matches(size, 0);
+        int matchCount = static_cast<int>(random() % 4);
+        for (int i = 0; i < matchCount; i++)
+        {
+            int edge = chunkSize * (1 + static_cast<int>(random() % (size / chunkSize)));
+            int position = edge - 1 + static_cast<int>(random() % 3);
+            matches[position < size ? position : size - 1] = 1;
+        }
+        if (random() % 4 == 0)
+        {
+            matches[random() % 2 == 0 ? 0 : size - 1] = 1;
+        }
+        auto pred = [&matches](const int &value)
+        {
+            // Lets the other chunks run ahead now and then, so later chunks can find their match first.
+            if (value % 256 == 0)
+            {
+                this_thread::yield();
+            }
+            return matches[value] != 0;
+        };
+
+        int expected = -1;
+        try
+        {
+            expected = list.FindIndex(pred);
+        }
+        catch (const LinkedListException &)
+        {
+        }
+
+        int found = -1;
+        const int *element = nullptr;
+        try
+        {
+            found = list.FindIndex(pool, pred);
+            element = &list.Find(pool, pred);
+        }
+        catch (const LinkedListException &)
+        {
+        }
+        if (found != expected || (expected >= 0 && element != &list.Find(pred)))
+        {
+            failure = Mismatch(round, "findindex", "found " + to_string(found) + " in " + to_string(size) +
+                                                       " elements, expected " + to_string(expected));
+            return false;
+        }
+
+        vector<atomic<int>> visits(size);
+        for (atomic<int> &visit : visits)
+        {
+            visit = 0;
+        }
+        atomic<long long> sum(0);
+        list.ForEach(pool, [&visits, &sum](const int &value)
+                     {
+                         visits[value]++;
+                         sum += value; });
+
+        long long expectedSum = 0;
+        list.ForEach([&expectedSum](const int &value)
+                     { expectedSum += value; });
+        for (int i = 0; i < size; i++)
+        {
+            if (visits[i].load() != 1)
+            {
+                failure = Mismatch(round, "foreach", "element " + to_string(i) + " of " + to_string(size) +
+                                                         " visited " + to_string(visits[i].load()) + " times");
+                return false;
+            }
+        }
+        if (sum.load() != expectedSum)
+        {
+            failure = Mismatch(round, "foreach", "the elements add up to " + to_string(sum.load()) + ", expected " +
+                                                     to_string(expectedSum));
+            return false;
+        }
+    }
+    return true;
+}
+
+static const map<string, CheckFunction> checks = {
+    {"linked", CheckLinked},
+    {"sharedreads", CheckSharedReads},
+    {"indexed", CheckIndexed},
+    {"unrolled", CheckUnrolled},
+    {"unrolledthrows", CheckUnrolledThrows},
+    {"doubly", CheckDoubly},
+    {"iterators", CheckIterators},
+    {"splice", CheckSplice},
+    {"pool", CheckPool},
+    {"sharded", CheckSharded},
+    {"queue", CheckConcurrentQueue},
+    {"finegrained", CheckFineGrained},
+    {"finegrainedthrows", CheckFineGrainedThrows},
+    {"spsc", CheckSpsc},
+    {"snapshot", CheckSnapshot},
+    {"simd", CheckSimd},
+    {"view", CheckView},
+    {"appendrange", CheckAppendRange},
+    {"parallelsearch", CheckParallelSearch},
+};
+
+bool TestCheck(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() < 1 || params.size() > 3)
+    {
+        throw std::invalid_argument("check requires 1 to 3 parameters");
+    }
+
+    map<string, CheckFunction>::const_iterator check = checks.find(params[0]);
+    if (check == checks.end())
+    {
+        string names;
+        for (const auto &entry : checks)
+        {
+            names += " " + entry.first;
+        }
+        throw std::invalid_argument("check structure must be one of" + names);
+    }
+
+    unsigned seed = params.size() > 1 ? static_cast<unsigned>(stoul(params[1])) : 1;
+    int operations = params.size() > 2 ? stoi(params[2]) : 2000;
+    if (operations < 0)
+    {
+        throw std::invalid_argument("check operations must not be negative");
+    }
+
+    string failure;
+    output = check->second(seed, operations, failure) ? "ok" : failure;
+
+    return true;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "helpers.hpp"
+
+/// @brief The check commands.  Each one runs a self-checking test of one list implementation, such as
+/// random edits compared with a std::vector, and outputs "ok" or a description of the first mismatch.
+extern std::vector<TestFunctionEntry> checkTestCommands;
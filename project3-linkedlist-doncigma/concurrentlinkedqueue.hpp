@@ -0,0 +1,181 @@
+/// @file concurrentlinkedqueue.hpp
+/// @brief A lock-free multi-producer, multi-consumer queue
+/// @details This is the Michael-Scott queue.  The nodes have the same layout as LinkedList nodes, a value
+/// and a pointer to the next node, except that the pointer is atomic.  The queue always starts with a
+/// dummy node, so Append only ever touches the tail and PopFront only ever touches the head, and both
+/// finish with a single compare-and-swap.  A thread that finds the tail lagging behind helps move it.
+///
+/// A popped node cannot be freed right away because another thread may still be reading it.  Every
+/// operation pins the queue's EpochReclaimer, and popped nodes are retired to it, which frees them once
+/// no operation that could have reached them is still running.
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "epochreclaimer.hpp"
+#include "stripedcounter.hpp"
+
+/// @brief A lock-free queue with Append at the tail and PopFront at the head
+/// @tparam T The type of the elements stored in the queue.  Must be copy constructible.
+template <typename T>
+class ConcurrentLinkedQueue
+{
+public:
+    /// @brief Constructor - sets up the dummy node of an empty queue.
+    ConcurrentLinkedQueue()
+    {
+        Node *dummy = new Node();
+        _head.store(dummy);
+        _tail.store(dummy);
+    }
+
+    /// @brief Destructor - frees all nodes.  No other thread may be using the queue.
+    ~ConcurrentLinkedQueue()
+    {
+        Node *ptr = _head.load();
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next.load();
+            delete nodeToDel;
+        }
+    }
+
+    ConcurrentLinkedQueue(const ConcurrentLinkedQueue &) = delete;
+    ConcurrentLinkedQueue &operator=(const ConcurrentLinkedQueue &) = delete;
+
+    /// @brief Adds a new element to the end of the queue.  Safe to call from any number of threads.
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        Node *newNode = new Node(value);
+        EpochReclaimer::Guard guard = _reclaimer.Pin();
+
+        while (true)
+        {
+            Node *tail = _tail.load();
+            Node *next = tail->next.load();
+
+            if (tail != _tail.load())
+            {
+                continue;
+            }
+
+            if (next == nullptr)
+            {
+                if (tail->next.compare_exchange_weak(next, newNode))
+                {
+                    // Swing the tail forward.  If this fails another thread already helped.
+                    _tail.compare_exchange_strong(tail, newNode);
+                    _size.Increment();
+                    break;
+                }
+            }
+            else
+            {
+                // The tail is lagging behind, help move it before trying again.
+                _tail.compare_exchange_strong(tail, next);
+            }
+        }
+    }
+
+    /// @brief Removes the first element of the queue.  Safe to call from any number of threads.
+    /// @param value Set to the removed element when the queue was not empty
+    /// @return True if an element was removed, false if the queue was empty
+    bool PopFront(T &value)
+    {
+        EpochReclaimer::Guard guard = _reclaimer.Pin();
+
+        while (true)
+        {
+            Node *head = _head.load();
+            Node *tail = _tail.load();
+            Node *next = head->next.load();
+
+            if (head != _head.load())
+            {
+                continue;
+            }
+
+            if (head == tail)
+            {
+                if (next == nullptr)
+                {
+                    return false;
+                }
+
+                _tail.compare_exchange_strong(tail, next);
+            }
+            else if (_head.compare_exchange_strong(head, next))
+            {
+                // next is the new dummy node and only the winner of the swap reads its value.  Another
+                // consumer may retire it right away, but it stays allocated while we are pinned.
+                value = std::move(next->Data());
+                _reclaimer.Retire(head);
+                _size.Decrement();
+                return true;
+            }
+        }
+    }
+
+    /// @brief Function to check if the queue is empty.  Only a snapshot when other threads are active.
+    /// @return True if the queue is empty, false otherwise
+    bool Empty() const
+    {
+        return _head.load()->next.load() == nullptr;
+    }
+
+    /// @brief Function to get the number of elements in the queue.  Only a snapshot when other threads are active.
+    /// @param mode Exact counts every Append and PopFront that finished before the call.  Approximate is a
+    /// single load, off by less than StripedCounter::PublishInterval per stripe.
+    /// @return The number of elements in the queue
+    int Size(SizeMode mode = SizeMode::Exact) const
+    {
+        // A PopFront can be counted before the Append of the element it took, so clamp at 0.
+        long size = _size.Get(mode);
+        return size < 0 ? 0 : static_cast<int>(size);
+    }
+
+private:
+    /// @brief Node class.  A value and a pointer to the next node, like LinkedList nodes.
+    class Node
+    {
+    public:
+        std::atomic<Node *> next; ///< Pointer to the next node
+        bool hasData;             ///< False only for the initial dummy node
+
+        Node() : next(nullptr), hasData(false) {}
+
+        /// @brief Constructor that copies the value into the node.
+        /// @param value The value to be copied into the node
+        Node(const T &value) : next(nullptr), hasData(true)
+        {
+            new (&data) T(value);
+        }
+
+        ~Node()
+        {
+            if (hasData)
+            {
+                Data().~T();
+            }
+        }
+
+        T &Data()
+        {
+            return *reinterpret_cast<T *>(&data);
+        }
+
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data; ///< The data stored in the node
+    };
+
+    std::atomic<Node *> _head; ///< The dummy node in front of the first element
+    std::atomic<Node *> _tail; ///< The last node, or a node shortly before it
+    EpochReclaimer _reclaimer; ///< Frees popped nodes once no operation can reach them
+    StripedCounter _size;      ///< The number of elements, on per-thread stripes
+};
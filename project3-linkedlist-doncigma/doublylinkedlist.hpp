@@ -0,0 +1,332 @@
+/// @file doublylinkedlist.hpp
+/// @brief A doubly linked list implementation
+/// @details Each node keeps a pointer to the previous node as well as the next one.  That costs one
+/// pointer per element but lets the list remove its tail in O(1) and start any positional operation
+/// from whichever end is closer, so the worst case walk is half the list.
+#pragma once
+
+#include <memory>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+
+/// @brief A doubly linked list with the same interface as LinkedList plus reverse traversal
+/// @tparam T The type of the elements stored in the list
+/// @tparam Allocator Allocator used for the nodes.  It is rebound to the node type.
+template <typename T, typename Allocator = NodePool<T>>
+class DoublyLinkedList
+{
+public:
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    DoublyLinkedList()
+    {
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+    }
+
+    /// @brief Destructor - cleans up all memory allocated by this class
+    ~DoublyLinkedList()
+    {
+        if (_size > 0)
+        {
+            Clear();
+        }
+    }
+
+    DoublyLinkedList(const DoublyLinkedList &) = delete;
+    DoublyLinkedList &operator=(const DoublyLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the list
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        LinkBefore(nullptr, CreateNode(value));
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be added
+    void Prepend(const T &value)
+    {
+        LinkBefore(_head, CreateNode(value));
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be inserted
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid
+    void InsertAt(const T &value, int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("InsertAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position > _size)
+        {
+            throw LinkedListException("Invalid index, InsertAt()");
+        }
+
+        Node *next = position == _size ? nullptr : NodeAt(position);
+        LinkBefore(next, CreateNode(value));
+    }
+
+    /// @brief Function to remove an element at a specific position
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid
+    void RemoveAt(int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Node *node = NodeAt(position);
+
+        if (node->prev != nullptr)
+        {
+            node->prev->next = node->next;
+        }
+        else
+        {
+            _head = node->next;
+        }
+
+        if (node->next != nullptr)
+        {
+            node->next->prev = node->prev;
+        }
+        else
+        {
+            _tail = node->prev;
+        }
+
+        DestroyNode(node);
+        _size--;
+    }
+
+    /// @brief Function to get the size of the linked list
+    /// @return The size of the linked list
+    int Size() const
+    {
+        return _size;
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    /// @brief Function to clear the linked list
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("List already empty, Clear()");
+        }
+
+        Node *ptr = _head;
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next;
+            DestroyNode(nodeToDel);
+        }
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T Get(int position) const
+    {
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, Get()");
+        }
+
+        return NodeAt(position)->data;
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T operator[](int position) const
+    {
+        return Get(position);
+    }
+
+    /// @brief Function to find an element that satisfies a predicate
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    T Find(Predicate pred) const
+    {
+        for (Node *ptr = _head; ptr; ptr = ptr->next)
+        {
+            if (pred(ptr->data))
+            {
+                return ptr->data;
+            }
+        }
+        throw LinkedListException("Invalid index, Find()");
+    }
+
+    /// @brief Finds the index of the first element in the list that satisfies the given predicate.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        int position = 0;
+
+        for (Node *ptr = _head; ptr; ptr = ptr->next)
+        {
+            if (pred(ptr->data))
+            {
+                return position;
+            }
+            position++;
+        }
+        throw LinkedListException("Invalid index, FindIndex()");
+    }
+
+    /// @brief Applies a function to each element of the linked list, from the head to the tail.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        for (Node *ptr = _head; ptr; ptr = ptr->next)
+        {
+            func(ptr->data);
+        }
+    }
+
+    /// @brief Applies a function to each element of the linked list, from the tail to the head.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEachReverse(Function func) const
+    {
+        for (Node *ptr = _tail; ptr; ptr = ptr->prev)
+        {
+            func(ptr->data);
+        }
+    }
+
+private:
+    /// @brief Node class
+    class Node
+    {
+    public:
+        T data;     ///< The data stored in the node
+        Node *prev; ///< Pointer to the previous node
+        Node *next; ///< Pointer to the next node
+
+        /// @brief Constructor that copies the value into the node.  Template type must support copy constructor.
+        /// @param value The value to be copied into the node
+        Node(const T &value) : data(value), prev(nullptr), next(nullptr) {}
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+
+    /// @brief Finds the node at a valid position, walking from whichever end is closer.
+    /// @param position The position of the node.  Must be a valid position.
+    /// @return The node at the position
+    Node *NodeAt(int position) const
+    {
+        Node *ptr;
+
+        if (position < _size / 2)
+        {
+            ptr = _head;
+            for (int i = 0; i < position; i++)
+            {
+                ptr = ptr->next;
+            }
+        }
+        else
+        {
+            ptr = _tail;
+            for (int i = _size - 1; i > position; i--)
+            {
+                ptr = ptr->prev;
+            }
+        }
+        return ptr;
+    }
+
+    /// @brief Links a new node in front of next, or at the tail when next is null.
+    void LinkBefore(Node *next, Node *newNode)
+    {
+        Node *prev = next != nullptr ? next->prev : _tail;
+
+        newNode->prev = prev;
+        newNode->next = next;
+
+        if (prev != nullptr)
+        {
+            prev->next = newNode;
+        }
+        else
+        {
+            _head = newNode;
+        }
+
+        if (next != nullptr)
+        {
+            next->prev = newNode;
+        }
+        else
+        {
+            _tail = newNode;
+        }
+
+        _size++;
+    }
+
+    Node *CreateNode(const T &value)
+    {
+        Node *node = NodeAllocatorTraits::allocate(_allocator, 1);
+
+        try
+        {
+            NodeAllocatorTraits::construct(_allocator, node, value);
+        }
+        catch (...)
+        {
+            NodeAllocatorTraits::deallocate(_allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void DestroyNode(Node *node)
+    {
+        NodeAllocatorTraits::destroy(_allocator, node);
+        NodeAllocatorTraits::deallocate(_allocator, node, 1);
+    }
+
+    Node *_head; ///< Pointer to the first node
+    Node *_tail; ///< Pointer to the last node
+    int _size;   ///< The number of elements in the list
+
+    NodeAllocator _allocator; ///< Allocator used for every node in the list
+};
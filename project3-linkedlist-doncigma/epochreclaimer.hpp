@@ -0,0 +1,407 @@
+/// @file epochreclaimer.hpp
+/// @brief Epoch-based reclamation of nodes removed from lock-free lists
+/// @details A node unlinked from a lock-free list may still be in use by threads that read the pointer to
+/// it just before the unlink, so it cannot be freed right away.  With epoch-based reclamation every
+/// operation on the list pins the thread to the current global epoch first, and an unlinked node is
+/// retired, tagged with the epoch it was retired in, instead of freed.
+///
+/// The global epoch only advances once every pinned thread has seen it.  So once the epoch is two past the
+/// tag of a retired node, every thread that was pinned when the node was unlinked has since unpinned, and
+/// nobody can still hold a pointer to it.
+///
+/// Threads register with a reclaimer the first time they pin it and are unregistered when they exit.  Each
+/// registered thread owns a slot with its epoch and its own list of retired nodes, so pinning and retiring
+/// never take a lock.  Every few retires a thread tries to advance the epoch and frees what has become safe.
+/// A thread whose garbage grows past a limit does so on every retire and yields in between, so a thread
+/// that was preempted while pinned gets to finish; the garbage stays bounded as long as no thread stays
+/// pinned indefinitely.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+/// @brief Tracks which threads are inside an operation and frees retired nodes once none can reach them
+class EpochReclaimer
+{
+    struct Slot;
+
+public:
+    /// @brief The size of a cache line on the platforms we run on
+    static const std::size_t CacheLineSize = 64;
+
+    /// @brief The most threads that can be registered at the same time.  Further threads wait for a slot.
+    static const int MaxThreads = 128;
+
+    /// @brief How many nodes a thread retires between attempts to advance the epoch and free its garbage.
+    static const std::size_t ReclaimInterval = 64;
+
+    /// @brief Past this many waiting nodes a thread tries to reclaim on every retire, and yields to let
+    /// threads that are holding the epoch back finish their operations.
+    static const std::size_t GarbageLimit = 1024;
+
+    /// @brief Keeps the calling thread pinned while it exists.  Pins nest, so an operation may call another.
+    class Guard
+    {
+    public:
+        /// @brief Constructor - pins the calling thread.
+        /// @param reclaimer The reclaimer to pin
+        explicit Guard(EpochReclaimer &reclaimer) : _reclaimer(&reclaimer)
+        {
+            _slot = &reclaimer.LocalSlot();
+            reclaimer.Pin(*_slot);
+        }
+
+        /// @brief Move constructor - takes over another guard, which no longer pins anything.
+        /// @param other The guard to take over
+        Guard(Guard &&other) : _reclaimer(other._reclaimer), _slot(other._slot)
+        {
+            other._slot = nullptr;
+        }
+
+        /// @brief Destructor - unpins the thread once the outermost guard is gone.
+        ~Guard()
+        {
+            if (_slot != nullptr)
+            {
+                _reclaimer->Unpin(*_slot);
+            }
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        EpochReclaimer *_reclaimer; ///< The reclaimer the thread is pinned to
+        Slot *_slot;                ///< The slot of the pinned thread
+    };
+
+    /// @brief Constructor - starts at epoch 0 with no threads registered.
+    EpochReclaimer() : _epoch(0), _slotsUsed(0)
+    {
+        static std::atomic<uint64_t> nextId(1);
+        _id = nextId++;
+
+        std::lock_guard<std::mutex> guard(RegistryLock());
+        Registry().insert(_id);
+    }
+
+    /// @brief Destructor - frees every node still waiting.  No thread may be using the reclaimer.
+    ~EpochReclaimer()
+    {
+        {
+            std::lock_guard<std::mutex> guard(RegistryLock());
+            Registry().erase(_id);
+        }
+
+        for (int i = 0; i < MaxThreads; i++)
+        {
+            FreeAll(_slots[i].garbage);
+        }
+        FreeAll(_orphans);
+    }
+
+    EpochReclaimer(const EpochReclaimer &) = delete;
+    EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+
+    /// @brief Pins the calling thread for the lifetime of the returned guard.  Any node reached while
+    /// pinned stays allocated until the guard is gone, even if another thread retires it.
+    /// @return The guard
+    Guard Pin()
+    {
+        return Guard(*this);
+    }
+
+    /// @brief Hands a node that has been unlinked to the reclaimer, which deletes it once no pinned thread
+    /// can still reach it.  The node must no longer be reachable by threads that pin from now on.
+    /// @tparam U The type of the node.  It is freed with delete.
+    /// @param node The node to retire
+    template <typename U>
+    void Retire(U *node)
+    {
+        Retire(node, [](void *ptr)
+               { delete static_cast<U *>(ptr); });
+    }
+
+    /// @brief Hands a node that has been unlinked to the reclaimer, which frees it with a custom function
+    /// once no pinned thread can still reach it.
+    /// @param node The node to retire
+    /// @param deleter The function that frees the node
+    void Retire(void *node, void (*deleter)(void *))
+    {
+        Slot &slot = LocalSlot();
+
+        slot.garbage.push_back(Garbage{node, deleter, _epoch.load()});
+        slot.pending.store(slot.garbage.size(), std::memory_order_relaxed);
+
+        if (++slot.retiredSinceReclaim >= ReclaimInterval || slot.garbage.size() > GarbageLimit)
+        {
+            Reclaim(slot);
+
+            if (slot.garbage.size() > GarbageLimit)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /// @brief Tries to advance the epoch and frees the calling thread's nodes that have become safe to free.
+    void Reclaim()
+    {
+        Reclaim(LocalSlot());
+    }
+
+    /// @brief Function to get the current global epoch
+    /// @return The epoch
+    uint64_t Epoch() const
+    {
+        return _epoch.load();
+    }
+
+    /// @brief Function to count the retired nodes that have not been freed yet.  A snapshot when other
+    /// threads are active.
+    /// @return The number of nodes waiting
+    std::size_t Pending() const
+    {
+        std::size_t pending = 0;
+        int used = _slotsUsed.load();
+
+        for (int i = 0; i < used; i++)
+        {
+            pending += _slots[i].pending.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> guard(_orphansLock);
+        return pending + _orphans.size();
+    }
+
+private:
+    /// @brief Marks a thread that is pinned.  The rest of its slot's state holds the epoch it pinned.
+    static const uint64_t Active = 1;
+
+    /// @brief A retired node and the epoch it was retired in
+    struct Garbage
+    {
+        void *node;              ///< The retired node
+        void (*deleter)(void *); ///< Frees the node
+        uint64_t epoch;          ///< The global epoch when the node was retired
+    };
+
+    /// @brief The state of one registered thread, on its own cache line
+    struct alignas(CacheLineSize) Slot
+    {
+        std::atomic<uint64_t> state;      ///< The pinned epoch times two plus Active, or 0 while not pinned
+        std::atomic<bool> inUse;          ///< Set while a thread owns the slot
+        std::atomic<std::size_t> pending; ///< The size of garbage, for Pending()
+        int pins;                         ///< How many guards the owner holds
+        std::size_t retiredSinceReclaim;  ///< Retires since the owner last reclaimed
+        std::deque<Garbage> garbage;      ///< The owner's retired nodes, oldest first
+
+        Slot() : state(0), inUse(false), pending(0), pins(0), retiredSinceReclaim(0) {}
+    };
+
+    /// @brief The slots a thread holds, with the id of the reclaimer each belongs to.  Frees them when
+    /// the thread exits, for every reclaimer that still exists.
+    struct ThreadRegistration
+    {
+        struct Entry
+        {
+            EpochReclaimer *reclaimer;
+            uint64_t id;
+            Slot *slot;
+        };
+
+        std::vector<Entry> entries;
+
+        ~ThreadRegistration()
+        {
+            std::lock_guard<std::mutex> guard(RegistryLock());
+
+            for (const Entry &entry : entries)
+            {
+                if (Registry().count(entry.id) != 0)
+                {
+                    entry.reclaimer->Unregister(*entry.slot);
+                }
+            }
+        }
+    };
+
+    /// @brief Guards Registry().  Never destroyed, so threads exiting during static destruction can use it.
+    static std::mutex &RegistryLock()
+    {
+        static std::mutex *lock = new std::mutex();
+        return *lock;
+    }
+
+    /// @brief The ids of the reclaimers that exist.  A thread only unregisters from those on exit.
+    static std::set<uint64_t> &Registry()
+    {
+        static std::set<uint64_t> *registry = new std::set<uint64_t>();
+        return *registry;
+    }
+
+    /// @brief Finds the calling thread's slot, registering the thread on first use.
+    Slot &LocalSlot()
+    {
+        static thread_local ThreadRegistration registration;
+
+        for (const ThreadRegistration::Entry &entry : registration.entries)
+        {
+            if (entry.reclaimer == this && entry.id == _id)
+            {
+                return *entry.slot;
+            }
+        }
+
+        // Forget the reclaimers that no longer exist while we are on the slow path anyway.
+        {
+            std::lock_guard<std::mutex> guard(RegistryLock());
+            std::vector<ThreadRegistration::Entry> &entries = registration.entries;
+            std::size_t kept = 0;
+
+            for (std::size_t i = 0; i < entries.size(); i++)
+            {
+                if (Registry().count(entries[i].id) != 0)
+                {
+                    entries[kept++] = entries[i];
+                }
+            }
+            entries.resize(kept);
+        }
+
+        Slot &slot = Register();
+        registration.entries.push_back(ThreadRegistration::Entry{this, _id, &slot});
+        return slot;
+    }
+
+    /// @brief Claims a free slot for the calling thread.
+    Slot &Register()
+    {
+        int i = 0;
+
+        while (true)
+        {
+            bool expected = false;
+            if (_slots[i].inUse.compare_exchange_strong(expected, true))
+            {
+                break;
+            }
+            if (++i == MaxThreads)
+            {
+                i = 0;
+                std::this_thread::yield();
+            }
+        }
+
+        // TryAdvance only looks at the slots below the high-water mark.
+        int used = _slotsUsed.load();
+        while (used <= i && !_slotsUsed.compare_exchange_weak(used, i + 1))
+        {
+        }
+        return _slots[i];
+    }
+
+    /// @brief Gives up a slot of an exiting thread.  Its garbage is handed over to the orphans.
+    void Unregister(Slot &slot)
+    {
+        {
+            std::lock_guard<std::mutex> guard(_orphansLock);
+            _orphans.insert(_orphans.end(), slot.garbage.begin(), slot.garbage.end());
+        }
+
+        slot.garbage.clear();
+        slot.pending.store(0, std::memory_order_relaxed);
+        slot.retiredSinceReclaim = 0;
+        slot.inUse.store(false);
+    }
+
+    void Pin(Slot &slot)
+    {
+        if (slot.pins++ > 0)
+        {
+            return;
+        }
+
+        // Announce the epoch before reading anything from the list.  The fence keeps the loads that follow
+        // from being reordered before the store.
+        slot.state.store(_epoch.load() * 2 + Active);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void Unpin(Slot &slot)
+    {
+        if (--slot.pins == 0)
+        {
+            slot.state.store(0, std::memory_order_release);
+        }
+    }
+
+    /// @brief Advances the global epoch if every pinned thread has seen the current one.
+    void TryAdvance()
+    {
+        uint64_t epoch = _epoch.load();
+        int used = _slotsUsed.load();
+
+        for (int i = 0; i < used; i++)
+        {
+            uint64_t state = _slots[i].state.load();
+
+            if ((state & Active) != 0 && state / 2 != epoch)
+            {
+                return;
+            }
+        }
+
+        _epoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void Reclaim(Slot &slot)
+    {
+        slot.retiredSinceReclaim = 0;
+        TryAdvance();
+
+        uint64_t epoch = _epoch.load();
+
+        // Nodes retired two epochs ago are unreachable.  The garbage is in epoch order, so stop at the first
+        // node that is too new.
+        while (!slot.garbage.empty() && slot.garbage.front().epoch + 2 <= epoch)
+        {
+            slot.garbage.front().deleter(slot.garbage.front().node);
+            slot.garbage.pop_front();
+        }
+        slot.pending.store(slot.garbage.size(), std::memory_order_relaxed);
+
+        // Garbage left behind by exited threads is freed by whoever gets here first.
+        std::unique_lock<std::mutex> guard(_orphansLock, std::try_to_lock);
+        if (guard.owns_lock())
+        {
+            while (!_orphans.empty() && _orphans.front().epoch + 2 <= epoch)
+            {
+                _orphans.front().deleter(_orphans.front().node);
+                _orphans.pop_front();
+            }
+        }
+    }
+
+    static void FreeAll(std::deque<Garbage> &garbage)
+    {
+        for (const Garbage &item : garbage)
+        {
+            item.deleter(item.node);
+        }
+        garbage.clear();
+    }
+
+    std::atomic<uint64_t> _epoch;    ///< The global epoch
+    uint64_t _id;                    ///< Tells this reclaimer apart from an earlier one at the same address
+    std::atomic<int> _slotsUsed;     ///< Every slot ever claimed is below this mark
+    Slot _slots[MaxThreads];         ///< The registered threads
+    mutable std::mutex _orphansLock; ///< Guards _orphans
+    std::deque<Garbage> _orphans;    ///< Garbage of threads that exited before it could be freed
+};
@@ -0,0 +1,347 @@
+/// @file finegrainedlinkedlist.hpp
+/// @brief A linked list with one lock per node for concurrent positional edits
+/// @details Every node, including a sentinel in front of the first element, carries its own mutex.
+/// Walks use lock coupling (hand-over-hand locking): the lock on the next node is taken before the lock
+/// on the current node is released.  A thread therefore only ever holds one or two neighbouring locks,
+/// so edits in different regions of the list run in parallel, while threads walking to the same region
+/// queue up behind each other in order and can never overtake or deadlock.
+///
+/// Because every walk starts at the sentinel, a node can only be reached by a thread holding the lock of
+/// its predecessor.  Unlinking a node while holding both its lock and its predecessor's lock guarantees
+/// nobody else is on it, so it can be freed right away.
+#pragma once
+
+#include <mutex>
+
+#include "linkedlist.hpp"
+#include "stripedcounter.hpp"
+
+/// @brief A thread safe linked list with per-node locks
+/// @tparam T The type of the elements stored in the list
+template <typename T>
+class FineGrainedLinkedList
+{
+public:
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    FineGrainedLinkedList() {}
+
+    /// @brief Destructor - cleans up all memory allocated by this class.  No other thread may be using the list.
+    ~FineGrainedLinkedList()
+    {
+        Node *ptr = _sentinel.next;
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next;
+            delete nodeToDel;
+        }
+    }
+
+    FineGrainedLinkedList(const FineGrainedLinkedList &) = delete;
+    FineGrainedLinkedList &operator=(const FineGrainedLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the list.  Walks the whole list, since there is
+    /// no tail pointer that could be kept consistent without a global lock.
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        Node *newNode = new Node(value);
+        Link *prev = LockSentinel();
+
+        while (prev->next != nullptr)
+        {
+            prev = LockNext(prev);
+        }
+
+        prev->next = newNode;
+        _size.Increment();
+        prev->lock.unlock();
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be added
+    void Prepend(const T &value)
+    {
+        Node *newNode = new Node(value);
+        Link *prev = LockSentinel();
+
+        newNode->next = prev->next;
+        prev->next = newNode;
+        _size.Increment();
+        prev->lock.unlock();
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be inserted
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid when the walk gets there
+    void InsertAt(const T &value, int position)
+    {
+        if (position < 0)
+        {
+            throw LinkedListException("Invalid index, InsertAt()");
+        }
+
+        Link *prev = LockSentinel();
+
+        if (prev->next == nullptr)
+        {
+            prev->lock.unlock();
+            throw LinkedListException("InsertAt() cannot be called on an empty list");
+        }
+
+        for (int i = 0; i < position; i++)
+        {
+            if (prev->next == nullptr)
+            {
+                prev->lock.unlock();
+                throw LinkedListException("Invalid index, InsertAt()");
+            }
+            prev = LockNext(prev);
+        }
+
+        Node *newNode;
+        try
+        {
+            newNode = new Node(value);
+        }
+        catch (...)
+        {
+            prev->lock.unlock();
+            throw;
+        }
+
+        newNode->next = prev->next;
+        prev->next = newNode;
+        _size.Increment();
+        prev->lock.unlock();
+    }
+
+    /// @brief Function to remove an element at a specific position
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid when the walk gets there
+    void RemoveAt(int position)
+    {
+        if (position < 0)
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Link *prev = LockSentinel();
+
+        if (prev->next == nullptr)
+        {
+            prev->lock.unlock();
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+
+        for (int i = 0; i < position; i++)
+        {
+            if (prev->next == nullptr)
+            {
+                prev->lock.unlock();
+                throw LinkedListException("Invalid index, RemoveAt()");
+            }
+            prev = LockNext(prev);
+        }
+
+        Node *node = prev->next;
+        if (node == nullptr)
+        {
+            prev->lock.unlock();
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        // Wait for any thread still on the node to move past it, then unlink it.
+        node->lock.lock();
+        prev->next = node->next;
+        _size.Decrement();
+        node->lock.unlock();
+        prev->lock.unlock();
+
+        delete node;
+    }
+
+    /// @brief Function to get the size of the linked list.  Safe to call while other threads edit the list.
+    /// @param mode Exact counts every edit that finished before the call.  Approximate is a single load,
+    /// off by less than StripedCounter::PublishInterval per stripe.
+    /// @return The size of the linked list
+    int Size(SizeMode mode = SizeMode::Exact) const
+    {
+        long size = _size.Get(mode);
+        return size < 0 ? 0 : static_cast<int>(size);
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @param mode How to read the size, see Size()
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty(SizeMode mode = SizeMode::Exact) const
+    {
+        return Size(mode) == 0;
+    }
+
+    /// @brief Function to clear the linked list.  Removes the elements from the front one at a time, so
+    /// threads already walking further down the list finish before their nodes are freed.
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        Link *prev = LockSentinel();
+
+        if (prev->next == nullptr)
+        {
+            prev->lock.unlock();
+            throw LinkedListException("List already empty, Clear()");
+        }
+
+        while (prev->next != nullptr)
+        {
+            Node *node = prev->next;
+
+            node->lock.lock();
+            prev->next = node->next;
+            _size.Decrement();
+            node->lock.unlock();
+
+            delete node;
+        }
+        prev->lock.unlock();
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return A copy of the element at the specified position
+    /// @throws LinkedListException if the position is invalid when the walk gets there
+    T Get(int position) const
+    {
+        if (position < 0)
+        {
+            throw LinkedListException("Invalid index, Get()");
+        }
+
+        std::unique_lock<std::mutex> held(_sentinel.lock);
+        Link *prev = &_sentinel;
+        Node *node = nullptr;
+
+        for (int i = 0; i <= position; i++)
+        {
+            if (prev->next == nullptr)
+            {
+                throw LinkedListException("Invalid index, Get()");
+            }
+            node = LockNext(prev, held);
+            prev = node;
+        }
+
+        // Copied while the node is still locked.  A copy that throws unlocks it on the way out.
+        return node->data;
+    }
+
+    /// @brief Finds the index of the first element in the list that satisfies the given predicate.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.  Called with the element's lock held,
+    /// which is released if it throws.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        std::unique_lock<std::mutex> held(_sentinel.lock);
+        Link *prev = &_sentinel;
+        int position = 0;
+
+        while (prev->next != nullptr)
+        {
+            Node *node = LockNext(prev, held);
+            prev = node;
+
+            if (pred(static_cast<const T &>(node->data)))
+            {
+                return position;
+            }
+            position++;
+        }
+
+        throw LinkedListException("Invalid index, FindIndex()");
+    }
+
+    /// @brief Applies a function to each element of the linked list, in order.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.  Called with the element's lock held, which is released if it throws.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        std::unique_lock<std::mutex> held(_sentinel.lock);
+        Link *prev = &_sentinel;
+
+        while (prev->next != nullptr)
+        {
+            Node *node = LockNext(prev, held);
+            prev = node;
+            func(static_cast<const T &>(node->data));
+        }
+    }
+
+private:
+    class Node;
+
+    /// @brief The part of a node a walk goes through: the link to the next node and the lock guarding it.
+    /// The sentinel is just a Link, so T does not need a default constructor.
+    class Link
+    {
+    public:
+        Node *next;      ///< Pointer to the next node, guarded by lock
+        std::mutex lock; ///< Guards next, and the node's data while a walk is on it
+
+        Link() : next(nullptr) {}
+    };
+
+    /// @brief Node class
+    class Node : public Link
+    {
+    public:
+        T data; ///< The data stored in the node
+
+        /// @brief Constructor that copies the value into the node.
+        /// @param value The value to be copied into the node
+        Node(const T &value) : data(value) {}
+    };
+
+    /// @brief Starts a walk by locking the sentinel.
+    /// @return The sentinel, locked
+    Link *LockSentinel() const
+    {
+        _sentinel.lock.lock();
+        return &_sentinel;
+    }
+
+    /// @brief Moves a walk one node forward: locks the next node, then unlocks the current one.
+    /// @param current The current node or the sentinel, locked.  Its next must not be null.
+    /// @return The next node, locked
+    static Node *LockNext(Link *current)
+    {
+        Node *next = current->next;
+
+        next->lock.lock();
+        current->lock.unlock();
+        return next;
+    }
+
+    /// @brief Moves a walk that calls user code one node forward, with the lock held in a unique_lock so an
+    /// exception releases it: locks the next node, then unlocks the current one.
+    /// @param current The current node or the sentinel, locked by held.  Its next must not be null.
+    /// @param held Holds the lock of current, and holds the lock of the next node on return
+    /// @return The next node, locked
+    static Node *LockNext(Link *current, std::unique_lock<std::mutex> &held)
+    {
+        Node *next = current->next;
+        std::unique_lock<std::mutex> nextLock(next->lock);
+
+        // nextLock takes over the current lock and releases it on return.
+        held.swap(nextLock);
+        return next;
+    }
+
+    mutable Link _sentinel; ///< The link in front of the first element.  Mutable so const walks can lock it.
+    StripedCounter _size;   ///< The number of elements in the list, on per-thread stripes
+};
@@ -6,9 +6,39 @@
 
 using namespace std;
 
+/// @brief The stream PrintError writes to on this thread, or NULL for stderr.
+static thread_local ostream *errorStream = NULL;
+
+/// @brief The stream commands print to directly on this thread, or NULL for stdout.
+static thread_local ostream *outputStream = NULL;
+
 void PrintError(int line, int position, const string &message)
 {
-    cerr << line << ":" << position + 1 << ": Error - " << message << endl;
+    ErrorStream() << line << ":" << position + 1 << ": Error - " << message << endl;
+}
+
+ostream *SetErrorStream(ostream *stream)
+{
+    ostream *previous = errorStream;
+    errorStream = stream;
+    return previous;
+}
+
+ostream &ErrorStream()
+{
+    return errorStream != NULL ? *errorStream : cerr;
+}
+
+ostream *SetOutputStream(ostream *stream)
+{
+    ostream *previous = outputStream;
+    outputStream = stream;
+    return previous;
+}
+
+ostream &OutputStream()
+{
+    return outputStream != NULL ? *outputStream : cout;
 }
 
 std::string trim(const std::string &str)
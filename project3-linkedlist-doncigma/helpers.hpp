@@ -11,6 +11,24 @@
 /// @param message The error message to print.
 extern void PrintError(int line, int position, const std::string &message);
 
+/// @brief Sends the error messages of the calling thread to another stream, such as a buffer printed later.
+/// @param stream The stream to print errors to, or NULL for stderr.
+/// @return The stream errors went to before, to restore it later.
+extern std::ostream *SetErrorStream(std::ostream *stream);
+
+/// @brief Gets the stream PrintError writes to on the calling thread.
+/// @return The error stream
+extern std::ostream &ErrorStream();
+
+/// @brief Sends what commands print directly on the calling thread, such as help, to another stream.
+/// @param stream The stream to print to, or NULL for stdout.
+/// @return The stream output went to before, to restore it later.
+extern std::ostream *SetOutputStream(std::ostream *stream);
+
+/// @brief Gets the stream commands print to directly on the calling thread.
+/// @return The output stream
+extern std::ostream &OutputStream();
+
 /// @brief Trims whitespace from the beginning and end of a string
 /// @param str The string to trim
 /// @return The trimmed string
@@ -0,0 +1,442 @@
+/// @file indexedbyvaluelinkedlist.hpp
+/// @brief A linked list with a hash index from value to element for O(1) lookups by value
+/// @details The elements live in an ordinary LinkedList.  Next to it a hash multimap maps every value to
+/// the elements holding it, one entry per element, so duplicates each have their own entry.  Every edit
+/// updates the index incrementally: an insert adds the new element's entry and a remove takes out the
+/// entry of the removed element, which is told apart from equal values by its address.
+///
+/// Elements never move in memory, since LinkedList only relinks nodes, even when sorting.  So the index
+/// stays valid across sorts and only needs to change when elements are added or removed.  Elements are
+/// only handed out as const, because changing one in place would leave it under the wrong key.
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+
+/// @brief A linked list with O(1) Contains, FindNode, FindValue and Count by value
+/// @tparam T The type of the elements stored in the list.  Must be copy constructible and equality comparable.
+/// @tparam Hash The hash function for T
+/// @tparam Allocator Allocator used for the nodes of the list
+template <typename T, typename Hash = std::hash<T>, typename Allocator = NodePool<T>>
+class IndexedByValueLinkedList
+{
+public:
+    typedef typename LinkedList<T, Allocator>::const_iterator const_iterator;
+
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    IndexedByValueLinkedList()
+    {
+    }
+
+    IndexedByValueLinkedList(const IndexedByValueLinkedList &) = delete;
+    IndexedByValueLinkedList &operator=(const IndexedByValueLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the list
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        const T &element = _list.EmplaceBack(value);
+        IndexOrRemove(element, _list.Size() - 1);
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be added
+    void Prepend(const T &value)
+    {
+        const T &element = _list.EmplaceFront(value);
+        IndexOrRemove(element, 0);
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be inserted
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid
+    void InsertAt(const T &value, int position)
+    {
+        const T &element = _list.EmplaceAt(position, value);
+        IndexOrRemove(element, position);
+    }
+
+    /// @brief Function to add a range of values to the end of the list
+    /// @tparam InputIterator Iterator whose elements can construct a T
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    template <typename InputIterator>
+    void AppendRange(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+        {
+            Append(*first);
+        }
+    }
+
+    /// @brief Function to remove an element at a specific position
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid
+    void RemoveAt(int position)
+    {
+        if (_list.Empty())
+        {
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position >= _list.Size())
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Unindex(_list.Get(position));
+        _list.RemoveAt(position);
+    }
+
+    /// @brief Function to remove an element at a specific position without throwing on a bad position
+    /// @param position The position of the element to remove
+    /// @return True if the element was removed, false if the position is invalid
+    bool TryRemoveAt(int position)
+    {
+        if (position < 0 || position >= _list.Size())
+        {
+            return false;
+        }
+        RemoveAt(position);
+        return true;
+    }
+
+    /// @brief Removes every element that satisfies a predicate in a single walk, like LinkedList::RemoveIf.
+    /// The index entry of each element goes as the element is unlinked.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element, in order
+    /// @return The number of elements removed
+    template <typename Predicate>
+    int RemoveIf(Predicate pred)
+    {
+        return _list.RemoveIf([this, &pred](const T &element)
+                              {
+                                  if (!pred(element))
+                                  {
+                                      return false;
+                                  }
+                                  Unindex(element);
+                                  return true; });
+    }
+
+    /// @brief Removes every element equal to a value.  A value that is not in the list is rejected in O(1),
+    /// otherwise its index entries go at once and the list is walked once.
+    /// @param value The value to remove
+    /// @return The number of elements removed
+    int RemoveAll(const T &value)
+    {
+        if (!Contains(value))
+        {
+            return 0;
+        }
+        _index.erase(value);
+        return _list.RemoveAll(value);
+    }
+
+    /// @brief Removes a run of consecutive elements like LinkedList::RemoveRange.
+    /// @param start The position of the first element to remove
+    /// @param count The number of elements to remove
+    /// @throws LinkedListException if start or count is negative, or the run goes past the end of the list
+    void RemoveRange(int start, int count)
+    {
+        if (!TryRemoveRange(start, count))
+        {
+            throw LinkedListException("Invalid index, RemoveRange()");
+        }
+    }
+
+    /// @brief Removes a run of consecutive elements without throwing on a bad range.  The index entry of each
+    /// element goes during the same walk that unlinks the run.
+    /// @param start The position of the first element to remove
+    /// @param count The number of elements to remove
+    /// @return True if the run was removed, false if start or count is negative or the run goes past the end of the list
+    bool TryRemoveRange(int start, int count)
+    {
+        return _list.TryRemoveRange(start, count, [this](const T &element)
+                                    { Unindex(element); });
+    }
+
+    /// @brief Function to get the size of the linked list
+    /// @return The size of the linked list
+    int Size() const
+    {
+        return _list.Size();
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return _list.Empty();
+    }
+
+    /// @brief Function to clear the linked list
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        _list.Clear();
+        _index.clear();
+    }
+
+    /// @brief Function to clear the linked list without throwing when it is already empty
+    /// @return True if elements were removed, false if the list was already empty
+    bool TryClear()
+    {
+        if (_list.Empty())
+        {
+            return false;
+        }
+        Clear();
+        return true;
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return A reference to the element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    const T &Get(int position) const
+    {
+        return _list.Get(position);
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return A reference to the element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    const T &operator[](int position) const
+    {
+        return Get(position);
+    }
+
+    /// @brief Function to get the element at a specific position without throwing on a bad position
+    /// @param position The position of the element to get
+    /// @param value Set to a copy of the element when the position is valid
+    /// @return True if the position is valid, false otherwise
+    bool TryGet(int position, T &value) const
+    {
+        return _list.TryGet(position, value);
+    }
+
+    /// @brief Function to check if any element is equal to a value.  O(1) on average.
+    /// @param value The value to look for
+    /// @return True if an element is equal to value
+    bool Contains(const T &value) const
+    {
+        return _index.find(value) != _index.end();
+    }
+
+    /// @brief Function to find the element of a value.  O(1) on average.  When several elements are equal
+    /// to value it is unspecified which one is returned.
+    /// @param value The value to look for
+    /// @return A pointer to an element equal to value, or nullptr if there is none
+    const T *FindNode(const T &value) const
+    {
+        typename Index::const_iterator match = _index.find(value);
+        return match != _index.end() ? match->second : nullptr;
+    }
+
+    /// @brief Function to find an element equal to a value.  O(1) on average.
+    /// @param value The value to look for
+    /// @return A reference to an element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    const T &FindValue(const T &value) const
+    {
+        const T *element = FindNode(value);
+
+        if (element == nullptr)
+        {
+            throw LinkedListException("Invalid index, FindValue()");
+        }
+        return *element;
+    }
+
+    /// @brief Function to find an element equal to a value without throwing when there is none.  O(1) on average.
+    /// @param value The value to look for
+    /// @param found Set to a copy of an element equal to value
+    /// @return True if an element is equal to value, false otherwise
+    bool TryFindValue(const T &value, T &found) const
+    {
+        const T *element = FindNode(value);
+
+        if (element == nullptr)
+        {
+            return false;
+        }
+        found = *element;
+        return true;
+    }
+
+    /// @brief Finds the index of the first element equal to a value.  A value that is not in the list is
+    /// rejected in O(1), otherwise this walks the list up to the element.
+    /// @param value The value to look for
+    /// @return The index of the first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    int FindIndexOfValue(const T &value) const
+    {
+        if (!Contains(value))
+        {
+            throw LinkedListException("Invalid index, FindIndexOfValue()");
+        }
+        return _list.FindIndexOfValue(value);
+    }
+
+    /// @brief Finds the index of the first element equal to a value without throwing when there is none.
+    /// A value that is not in the list is rejected in O(1).
+    /// @param value The value to look for
+    /// @param index Set to the index of the first element equal to value
+    /// @return True if an element is equal to value, false otherwise
+    bool TryFindIndexOfValue(const T &value, int &index) const
+    {
+        if (!Contains(value))
+        {
+            return false;
+        }
+        index = _list.FindIndexOfValue(value);
+        return true;
+    }
+
+    /// @brief Counts the elements equal to a value.  O(1 + number of matches) on average.
+    /// @param value The value to count
+    /// @return The number of elements equal to value
+    int Count(const T &value) const
+    {
+        return static_cast<int>(_index.count(value));
+    }
+
+    /// @brief Function to find an element that satisfies a predicate.  A linear scan, like LinkedList::Find.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return A reference to the first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    const T &Find(Predicate pred) const
+    {
+        return _list.Find(pred);
+    }
+
+    /// @brief Finds the index of the first element in the list that satisfies the given predicate.  A linear scan.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        return _list.FindIndex(pred);
+    }
+
+    /// @brief Function to find an element that satisfies a predicate without throwing when there is none.  A linear scan.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @param value Set to a copy of the first element that satisfies the predicate
+    /// @return True if an element satisfies the predicate, false otherwise
+    template <typename Predicate>
+    bool TryFind(Predicate pred, T &value) const
+    {
+        return _list.TryFind(pred, value);
+    }
+
+    /// @brief Finds the index of the first element that satisfies a predicate without throwing when there is none.  A linear scan.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @param index Set to the index of the first element that satisfies the predicate
+    /// @return True if an element satisfies the predicate, false otherwise
+    template <typename Predicate>
+    bool TryFindIndex(Predicate pred, int &index) const
+    {
+        return _list.TryFindIndex(pred, index);
+    }
+
+    /// @brief Applies a function to each element of the linked list.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        _list.ForEach(func);
+    }
+
+    /// @brief Sorts the list in place like LinkedList::Sort.  Only relinks nodes, so the index is untouched.
+    /// @tparam Compare The comparison should take two const references to the data type stored in the list
+    /// and return true if the first should come before the second.
+    /// @param comp The comparison to sort by.  Defaults to ascending order.
+    template <typename Compare = std::less<T>>
+    void Sort(Compare comp = Compare())
+    {
+        _list.Sort(comp);
+    }
+
+    /// @brief Sorts the list in place on a pool of threads like LinkedList::ParallelSort.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam Compare The comparison should take two const references to the data type stored in the list
+    /// and return true if the first should come before the second.  It must not throw.
+    /// @param executor The pool to sort on
+    /// @param comp The comparison to sort by.  Defaults to ascending order.
+    template <typename Executor, typename Compare = std::less<T>>
+    void ParallelSort(Executor &executor, Compare comp = Compare())
+    {
+        _list.ParallelSort(executor, comp);
+    }
+
+    /// @brief Returns an iterator to the first element, or end() if the list is empty.
+    const_iterator begin() const
+    {
+        return _list.begin();
+    }
+
+    /// @brief Returns an iterator one past the last element.
+    const_iterator end() const
+    {
+        return _list.end();
+    }
+
+    /// @brief Starts a lazy pipeline over the elements like LinkedList::View.
+    /// @return A view of every element of the list
+    ListView<ListSource<LinkedList<T, Allocator>>> View() const
+    {
+        return _list.View();
+    }
+
+private:
+    typedef std::unordered_multimap<T, const T *, Hash> Index;
+
+    /// @brief Adds the index entry of a new element.  If that fails the element is removed again, so the
+    /// list and the index never disagree.
+    /// @param element The new element
+    /// @param position The position of the new element
+    void IndexOrRemove(const T &element, int position)
+    {
+        try
+        {
+            _index.insert(std::make_pair(element, &element));
+        }
+        catch (...)
+        {
+            _list.RemoveAt(position);
+            throw;
+        }
+    }
+
+    /// @brief Removes the index entry of an element, leaving the entries of equal elements alone.
+    /// @param element The element that is about to be removed
+    void Unindex(const T &element)
+    {
+        std::pair<typename Index::iterator, typename Index::iterator> matches = _index.equal_range(element);
+
+        for (typename Index::iterator match = matches.first; match != matches.second; ++match)
+        {
+            if (match->second == &element)
+            {
+                _index.erase(match);
+                return;
+            }
+        }
+    }
+
+    LinkedList<T, Allocator> _list; ///< The elements, in order
+    Index _index;                   ///< One entry per element, from its value to the element
+};
@@ -0,0 +1,443 @@
+/// @file indexedlinkedlist.hpp
+/// @brief A linked list with an indexable skip list on top of it
+/// @details The elements form an ordinary singly linked chain.  Some nodes also carry links on higher
+/// levels that skip over many nodes at once, and every link records its span, the number of positions it
+/// skips.  Walking down from the top level while adding up spans reaches any position in O(log n)
+/// expected time, so Get, InsertAt and RemoveAt no longer depend on how far into the list the position is.
+/// ForEach, Find and FindIndex simply walk the base chain in order.
+///
+/// A node gets each additional level with probability 1/4, so on average a node carries 1.33 links.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+
+/// @brief A linked list with O(log n) positional access
+/// @tparam T The type of the elements stored in the list
+/// @tparam Allocator Allocator used for the nodes.  It is rebound to the node and link types.
+template <typename T, typename Allocator = NodePool<T>>
+class IndexedLinkedList
+{
+public:
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    IndexedLinkedList()
+    {
+        _size = 0;
+        _levels = 1;
+        _random = 0x2545F4914F6CDD1DULL;
+        ResetHead();
+    }
+
+    /// @brief Destructor - cleans up all memory allocated by this class
+    ~IndexedLinkedList()
+    {
+        if (_size > 0)
+        {
+            Clear();
+        }
+    }
+
+    IndexedLinkedList(const IndexedLinkedList &) = delete;
+    IndexedLinkedList &operator=(const IndexedLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the list
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        Insert(value, _size);
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be added
+    void Prepend(const T &value)
+    {
+        Insert(value, 0);
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be inserted
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid
+    void InsertAt(const T &value, int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("InsertAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position > _size)
+        {
+            throw LinkedListException("Invalid index, InsertAt()");
+        }
+
+        Insert(value, position);
+    }
+
+    /// @brief Function to remove an element at a specific position
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid
+    void RemoveAt(int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Node *update[MaxLevels] = {};
+        int rank[MaxLevels] = {};
+        FindPredecessors(position, update, rank);
+
+        Node *node = LinkOf(update[0], 0).next;
+
+        for (int level = 0; level < _levels; level++)
+        {
+            Link &link = LinkOf(update[level], level);
+
+            if (link.next == node)
+            {
+                link.span += node->At(level).span - 1;
+                link.next = node->At(level).next;
+            }
+            else
+            {
+                link.span--;
+            }
+        }
+
+        while (_levels > 1 && _head[_levels - 1].next == nullptr)
+        {
+            _levels--;
+        }
+
+        DestroyNode(node);
+        _size--;
+    }
+
+    /// @brief Function to get the size of the linked list
+    /// @return The size of the linked list
+    int Size() const
+    {
+        return _size;
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    /// @brief Function to clear the linked list
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("List already empty, Clear()");
+        }
+
+        Node *ptr = _head[0].next;
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->At(0).next;
+            DestroyNode(nodeToDel);
+        }
+
+        _size = 0;
+        _levels = 1;
+        ResetHead();
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T Get(int position) const
+    {
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, Get()");
+        }
+
+        // The head has rank 0 and the element at position p has rank p + 1.
+        const Node *node = nullptr;
+        int traversed = 0;
+
+        for (int level = _levels - 1; level >= 0; level--)
+        {
+            const Link *link = &LinkOf(node, level);
+
+            while (link->next != nullptr && traversed + link->span <= position + 1)
+            {
+                traversed += link->span;
+                node = link->next;
+                link = &node->At(level);
+            }
+        }
+
+        return node->data;
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T operator[](int position) const
+    {
+        return Get(position);
+    }
+
+    /// @brief Function to find an element that satisfies a predicate
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    T Find(Predicate pred) const
+    {
+        for (Node *ptr = _head[0].next; ptr; ptr = ptr->At(0).next)
+        {
+            if (pred(ptr->data))
+            {
+                return ptr->data;
+            }
+        }
+        throw LinkedListException("Invalid index, Find()");
+    }
+
+    /// @brief Finds the index of the first element in the list that satisfies the given predicate.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        int position = 0;
+
+        for (Node *ptr = _head[0].next; ptr; ptr = ptr->At(0).next)
+        {
+            if (pred(ptr->data))
+            {
+                return position;
+            }
+            position++;
+        }
+        throw LinkedListException("Invalid index, FindIndex()");
+    }
+
+    /// @brief Applies a function to each element of the linked list.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        for (Node *ptr = _head[0].next; ptr; ptr = ptr->At(0).next)
+        {
+            func(ptr->data);
+        }
+    }
+
+private:
+    /// @brief The most levels a list can have.  Enough for far more elements than an int can count.
+    static const int MaxLevels = 32;
+
+    class Node;
+
+    /// @brief A link to the next node on one level
+    struct Link
+    {
+        Node *next; ///< The next node on this level, or nullptr at the end
+        int span;   ///< The number of positions between this node and next
+    };
+
+    /// @brief Node class.  The level 0 link is stored inline and forms the base chain.
+    class Node
+    {
+    public:
+        T data;      ///< The data stored in the node
+        int height;  ///< The number of levels this node is linked into
+        Link base;   ///< The link to the next node in the base chain
+        Link *upper; ///< Links for levels 1 to height - 1, or nullptr when height is 1
+
+        Node(const T &value, int nodeHeight, Link *upperLinks) : data(value), height(nodeHeight), upper(upperLinks)
+        {
+            base.next = nullptr;
+            base.span = 1;
+        }
+
+        Link &At(int level)
+        {
+            return level == 0 ? base : upper[level - 1];
+        }
+
+        const Link &At(int level) const
+        {
+            return level == 0 ? base : upper[level - 1];
+        }
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Link> LinkAllocator;
+    typedef std::allocator_traits<LinkAllocator> LinkAllocatorTraits;
+
+    /// @brief Returns the link of a node on a level, where a null node stands for the head.
+    Link &LinkOf(Node *node, int level)
+    {
+        return node == nullptr ? _head[level] : node->At(level);
+    }
+
+    const Link &LinkOf(const Node *node, int level) const
+    {
+        return node == nullptr ? _head[level] : node->At(level);
+    }
+
+    /// @brief Finds, on every level, the last node before a position.
+    /// @param position The position to find the predecessors of
+    /// @param update Set to the predecessor on each level, where nullptr stands for the head
+    /// @param rank Set to the rank of each predecessor.  The head has rank 0, position p has rank p + 1.
+    void FindPredecessors(int position, Node **update, int *rank)
+    {
+        Node *node = nullptr;
+        int traversed = 0;
+
+        for (int level = _levels - 1; level >= 0; level--)
+        {
+            Link *link = &LinkOf(node, level);
+
+            while (link->next != nullptr && traversed + link->span <= position)
+            {
+                traversed += link->span;
+                node = link->next;
+                link = &node->At(level);
+            }
+
+            update[level] = node;
+            rank[level] = traversed;
+        }
+    }
+
+    /// @brief Inserts a value at a position that has already been validated.
+    void Insert(const T &value, int position)
+    {
+        Node *update[MaxLevels] = {};
+        int rank[MaxLevels] = {};
+        FindPredecessors(position, update, rank);
+
+        int height = RandomHeight();
+        Node *newNode = CreateNode(value, height);
+
+        // New levels start out as a single link from the head that spans the whole list.
+        for (int level = _levels; level < height; level++)
+        {
+            update[level] = nullptr;
+            rank[level] = 0;
+            _head[level].next = nullptr;
+            _head[level].span = _size;
+        }
+        if (height > _levels)
+        {
+            _levels = height;
+        }
+
+        for (int level = 0; level < height; level++)
+        {
+            Link &link = LinkOf(update[level], level);
+            Link &newLink = newNode->At(level);
+            int skipped = rank[0] - rank[level];
+
+            newLink.next = link.next;
+            newLink.span = link.span - skipped;
+            link.next = newNode;
+            link.span = skipped + 1;
+        }
+
+        for (int level = height; level < _levels; level++)
+        {
+            LinkOf(update[level], level).span++;
+        }
+
+        _size++;
+    }
+
+    /// @brief Picks the height of a new node: each extra level with probability 1/4.
+    int RandomHeight()
+    {
+        // xorshift64, which is plenty for balancing and keeps the list self-contained.
+        _random ^= _random << 13;
+        _random ^= _random >> 7;
+        _random ^= _random << 17;
+
+        int height = 1;
+        uint64_t bits = _random;
+
+        while (height < MaxLevels && (bits & 3) == 0)
+        {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    void ResetHead()
+    {
+        for (int level = 0; level < MaxLevels; level++)
+        {
+            _head[level].next = nullptr;
+            _head[level].span = 0;
+        }
+    }
+
+    Node *CreateNode(const T &value, int height)
+    {
+        Link *upper = nullptr;
+        if (height > 1)
+        {
+            upper = LinkAllocatorTraits::allocate(_linkAllocator, height - 1);
+        }
+
+        Node *node = NodeAllocatorTraits::allocate(_allocator, 1);
+
+        try
+        {
+            NodeAllocatorTraits::construct(_allocator, node, value, height, upper);
+        }
+        catch (...)
+        {
+            NodeAllocatorTraits::deallocate(_allocator, node, 1);
+            if (upper != nullptr)
+            {
+                LinkAllocatorTraits::deallocate(_linkAllocator, upper, height - 1);
+            }
+            throw;
+        }
+        return node;
+    }
+
+    void DestroyNode(Node *node)
+    {
+        if (node->upper != nullptr)
+        {
+            LinkAllocatorTraits::deallocate(_linkAllocator, node->upper, node->height - 1);
+        }
+        NodeAllocatorTraits::destroy(_allocator, node);
+        NodeAllocatorTraits::deallocate(_allocator, node, 1);
+    }
+
+    Link _head[MaxLevels]; ///< The links out of the head on every level
+    int _levels;           ///< The number of levels in use, at least 1
+    int _size;             ///< The number of elements in the list
+    uint64_t _random;      ///< State of the random generator for node heights
+
+    NodeAllocator _allocator;     ///< Allocator used for every node in the list
+    LinkAllocator _linkAllocator; ///< Allocator used for the upper links of the nodes
+};
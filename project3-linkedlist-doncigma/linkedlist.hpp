@@ -4,9 +4,24 @@
 /// Each element of the list is represented by a node that contains a value and a pointer to the next node.
 /// The list is implemented as a template class, so it can hold elements of any type.
 /// The list is implemented as a singly linked list, so it can only be traversed in one direction.
+/// The list remembers the last position it walked to, so positional access in increasing order only
+/// walks forward from there instead of starting over at the head every time.
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "listview.hpp"
+#include "nodepool.hpp"
 
 /// @brief Exception class for linked list errors.  Allows us to catch known errors for our implementation.
 class LinkedListException : public std::exception
@@ -23,29 +38,166 @@ public:
 };
 
 /// @brief A basic linked list implementation
-template <typename T>
+/// @tparam T The type of the elements stored in the list
+/// @tparam Allocator Allocator used for the nodes.  It is rebound to the node type, so the default
+/// pools nodes in contiguous blocks.  Use std::allocator<T> to allocate every node from the heap.
+/// @details Like the standard containers, several threads may call const functions on the same list at
+/// once, as long as no thread changes it.  Positional calls through a non-const list resume from a cursor
+/// left by the previous one, so they are not safe to share between threads.
+template <typename T, typename Allocator = NodePool<T>>
 class LinkedList
 {
+private:
+    class Node;
+
 public:
+    /// @brief Forward iterator over the elements of the list.
+    /// @tparam IsConst Whether the iterator gives read-only access to the elements.
+    template <bool IsConst>
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const T *, T *>::type pointer;
+        typedef typename std::conditional<IsConst, const T &, T &>::type reference;
+
+        Iterator() : _node(nullptr) {}
+
+        /// @brief Converts a mutable iterator into a const one.
+        Iterator(const Iterator<false> &other) : _node(other._node) {}
+
+        reference operator*() const
+        {
+            return _node->data;
+        }
+
+        pointer operator->() const
+        {
+            return &_node->data;
+        }
+
+        Iterator &operator++()
+        {
+            _node = _node->next;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            _node = _node->next;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b)
+        {
+            return a._node == b._node;
+        }
+
+        friend bool operator!=(const Iterator &a, const Iterator &b)
+        {
+            return a._node != b._node;
+        }
+
+    private:
+        friend class LinkedList;
+        template <bool>
+        friend class Iterator;
+
+        explicit Iterator(Node *node) : _node(node) {}
+
+        Node *_node; ///< The current node, or nullptr at the end of the list
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
     /// @brief Constructor - sets the initial state to be empty and self-consistent.
     LinkedList()
     {
         _head = nullptr;
         _tail = nullptr;
         _size = 0;
+        ResetCursor();
+    }
+
+    /// @brief Constructor - sets the initial state to be empty and allocates nodes with a copy of the given allocator.
+    /// @param allocator The allocator to copy
+    explicit LinkedList(const Allocator &allocator) : _allocator(allocator)
+    {
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+        ResetCursor();
     }
 
     /// @brief Destructor - cleans up all memory allocated by this class
     ~LinkedList()
     {
-        Clear();
+        if (_size > 0)
+        {
+            Clear();
+        }
+    }
+
+    LinkedList(const LinkedList &) = delete;
+    LinkedList &operator=(const LinkedList &) = delete;
+
+    /// @brief Move constructor - takes over the nodes of another list and leaves it empty.
+    /// @param other The list to take the nodes from
+    LinkedList(LinkedList &&other) noexcept : _allocator(std::move(other._allocator))
+    {
+        _head = other._head;
+        _tail = other._tail;
+        _size = other._size;
+        ResetCursor();
+
+        other.Release();
+    }
+
+    /// @brief Move assignment - frees the current nodes, then takes over the nodes of another list.
+    /// @param other The list to take the nodes from
+    /// @return This list
+    LinkedList &operator=(LinkedList &&other)
+    {
+        if (this != &other) {
+            if (_size > 0) {
+                Clear();
+            }
+            _allocator = std::move(other._allocator);
+            _head = other._head;
+            _tail = other._tail;
+            _size = other._size;
+            ResetCursor();
+
+            other.Release();
+        }
+        return *this;
     }
 
     /// @brief Function to add a new element to the end of the list
     /// @param value The value to be added
     void Append(const T &value)
     {
-        Node *newNode = new Node(value);
+        EmplaceBack(value);
+    }
+
+    /// @brief Function to add a new element to the end of the list
+    /// @param value The value to be moved into the list
+    void Append(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    /// @brief Function to construct a new element in place at the end of the list
+    /// @param args The arguments to pass to the constructor of the element
+    /// @return The new element
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        Node *newNode = CreateNode(std::forward<Args>(args)...);
 
         if (_size > 0) {
             _tail->next = newNode;
@@ -61,19 +213,44 @@ public:
             _size++;
         }
         else throw LinkedListException("Invalid index, Append()");
+
+        return newNode->data;
     }
 
     /// @brief Function to add a new element to the beginning of the list
     /// @param value The value to be added
     void Prepend(const T &value)
     {
-        Node *newNode = new Node(value);
+        EmplaceFront(value);
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be moved into the list
+    void Prepend(T &&value)
+    {
+        EmplaceFront(std::move(value));
+    }
+
+    /// @brief Function to construct a new element in place at the beginning of the list
+    /// @param args The arguments to pass to the constructor of the element
+    /// @return The new element
+    template <typename... Args>
+    T &EmplaceFront(Args &&...args)
+    {
+        Node *newNode = CreateNode(std::forward<Args>(args)...);
 
         if (_size > 0) {
             newNode->next = _head;
             _head = newNode;
 
             _size++;
+
+            if (_cursorNode != nullptr) {
+                _cursorIndex++;
+                if (_cursorPrev == nullptr) {
+                    _cursorPrev = newNode;
+                }
+            }
         }
         else if (_head == nullptr) {
             _head = newNode;
@@ -83,6 +260,8 @@ public:
             _size++;
         } 
         else throw LinkedListException("Invalid index, Prepend()");
+
+        return newNode->data;
     }
 
     /// @brief Function to insert a new element at a specific position
@@ -90,33 +269,290 @@ public:
     /// @param position The position to insert the value at
     /// @throws LinkedListException if the position is invalid
     void InsertAt(const T &value, int position)
+    {
+        EmplaceAt(position, value);
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be moved into the list
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid
+    void InsertAt(T &&value, int position)
+    {
+        EmplaceAt(position, std::move(value));
+    }
+
+    /// @brief Function to construct a new element in place at a specific position
+    /// @param position The position to insert the element at
+    /// @param args The arguments to pass to the constructor of the element
+    /// @return The new element
+    /// @throws LinkedListException if the position is invalid
+    template <typename... Args>
+    T &EmplaceAt(int position, Args &&...args)
     {
         if (_size > 0) {
             if (position == 0) {
-                Prepend(value);
+                return EmplaceFront(std::forward<Args>(args)...);
             }
             else if (position == _size) {
-                Append(value);
+                return EmplaceBack(std::forward<Args>(args)...);
             }
             else if (position > 0 && position < _size && position > -1) {
-                Node *ptr = _head;
+                Node *nodeToInsert = CreateNode(std::forward<Args>(args)...);
                 Node *prevNode = nullptr;
-                Node *nodeToInsert = new Node(value);
+                Node *ptr = Seek(position, prevNode);
 
-                for (int i = 0; i < position; i++) {
-                    prevNode = ptr;
-                    ptr = ptr->next;
-                }
                 nodeToInsert->next = ptr;
                 prevNode->next = nodeToInsert;
                 
                 _size++;
+
+                // The new node now sits at the cursor position
+                _cursorNode = nodeToInsert;
+
+                return nodeToInsert->data;
             }
             else throw LinkedListException("Invalid index, InsertAt()");
         }
         else throw LinkedListException("InsertAt() cannot be called on an empty list");
     }
 
+    /// @brief Function to add a range of values to the end of the list.  The new nodes are built
+    /// off to the side and linked in with a single pointer update.
+    /// @tparam InputIterator Iterator whose elements can construct a T
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    template <typename InputIterator>
+    void AppendRange(InputIterator first, InputIterator last)
+    {
+        Node *chainHead = nullptr;
+        Node *chainTail = nullptr;
+        int count = BuildChain(first, last, chainHead, chainTail);
+
+        AttachChain(chainHead, chainTail, count);
+    }
+
+    /// @brief Function to add a range of values to the end of the list, building the nodes in parallel.
+    /// Each chunk of the range becomes a chain on some thread, and the chains are linked in order.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam RandomAccessIterator Iterator whose elements can construct a T
+    /// @param executor The pool to build the chains on.  The allocator is used from all of its threads,
+    /// which NodePool and std::allocator allow.
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    template <typename Executor, typename RandomAccessIterator>
+    void AppendRange(Executor &executor, RandomAccessIterator first, RandomAccessIterator last)
+    {
+        int count = static_cast<int>(last - first);
+        int chunkSize = ParallelChunkSize(executor.Size(), count);
+        int chunks = (count + chunkSize - 1) / chunkSize;
+
+        if (chunks < 2) {
+            AppendRange(first, last);
+            return;
+        }
+
+        std::vector<Node *> heads(chunks, nullptr);
+        std::vector<Node *> tails(chunks, nullptr);
+
+        try
+        {
+            executor.ParallelFor(chunks, [&](int chunk)
+                                 {
+                                     RandomAccessIterator chunkFirst = first + chunk * chunkSize;
+                                     RandomAccessIterator chunkLast = chunk == chunks - 1 ? last : chunkFirst + chunkSize;
+                                     BuildChain(chunkFirst, chunkLast, heads[chunk], tails[chunk]); });
+        }
+        catch (...)
+        {
+            // A chunk that failed freed its own nodes and left its head null, the others are freed here.
+            // ParallelFor only rethrows once every chunk has finished.
+            for (Node *chainHead : heads) {
+                DestroyChain(chainHead);
+            }
+            throw;
+        }
+
+        for (int i = 0; i + 1 < chunks; i++) {
+            tails[i]->next = heads[i + 1];
+        }
+        AttachChain(heads.front(), tails.back(), count);
+    }
+
+    /// @brief Function to add a range of values to the beginning of the list, keeping their order.
+    /// The new nodes are built off to the side and linked in with a single pointer update.
+    /// @tparam InputIterator Iterator whose elements can construct a T
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    template <typename InputIterator>
+    void PrependRange(InputIterator first, InputIterator last)
+    {
+        Node *chainHead = nullptr;
+        Node *chainTail = nullptr;
+        int count = BuildChain(first, last, chainHead, chainTail);
+
+        if (count == 0) {
+            return;
+        }
+
+        chainTail->next = _head;
+        if (_size == 0) {
+            _tail = chainTail;
+        }
+        _head = chainHead;
+        _size += count;
+
+        if (_cursorNode != nullptr) {
+            _cursorIndex += count;
+            if (_cursorPrev == nullptr) {
+                _cursorPrev = chainTail;
+            }
+        }
+    }
+
+    /// @brief Function to insert a range of values at a specific position, keeping their order.
+    /// The new nodes are built off to the side and linked in with a single pointer update.
+    /// @tparam InputIterator Iterator whose elements can construct a T
+    /// @param position The position to insert the first value at.  May be Size() to append.
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    /// @throws LinkedListException if the position is invalid
+    template <typename InputIterator>
+    void InsertRangeAt(int position, InputIterator first, InputIterator last)
+    {
+        if (position < 0 || position > _size) {
+            throw LinkedListException("Invalid index, InsertRangeAt()");
+        }
+
+        if (position == 0) {
+            PrependRange(first, last);
+            return;
+        }
+        if (position == _size) {
+            AppendRange(first, last);
+            return;
+        }
+
+        Node *chainHead = nullptr;
+        Node *chainTail = nullptr;
+        int count = BuildChain(first, last, chainHead, chainTail);
+
+        if (count == 0) {
+            return;
+        }
+
+        Node *prevNode = nullptr;
+        Node *ptr = Seek(position, prevNode);
+
+        chainTail->next = ptr;
+        prevNode->next = chainHead;
+        _size += count;
+
+        // The first new node now sits at the cursor position
+        _cursorNode = chainHead;
+    }
+
+    /// @brief Function to move all elements of another list to the end of this list.  Runs in O(1)
+    /// since the nodes are relinked rather than copied.  The other list is left empty.
+    /// @param other The list to take the elements from
+    void Splice(LinkedList &&other)
+    {
+        SpliceAt(_size, std::move(other));
+    }
+
+    /// @brief Function to move all elements of another list into this list at a specific position.
+    /// The nodes are relinked rather than copied.  The other list is left empty.
+    /// @param position The position to insert the first element of other at.  May be Size() to append.
+    /// @param other The list to take the elements from
+    /// @throws LinkedListException if the position is invalid
+    void SpliceAt(int position, LinkedList &&other)
+    {
+        if (position < 0 || position > _size) {
+            throw LinkedListException("Invalid index, SpliceAt()");
+        }
+
+        if (other._size == 0 || &other == this) {
+            return;
+        }
+
+        // Nodes must be freed by an allocator equal to the one that allocated them.
+        if (_allocator != other._allocator) {
+            InsertRangeAt(position, std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            other.Clear();
+            return;
+        }
+
+        if (position == _size) {
+            if (_size > 0) {
+                _tail->next = other._head;
+            }
+            else {
+                _head = other._head;
+            }
+            _tail = other._tail;
+        }
+        else if (position == 0) {
+            other._tail->next = _head;
+            _head = other._head;
+
+            if (_cursorNode != nullptr) {
+                _cursorIndex += other._size;
+                if (_cursorPrev == nullptr) {
+                    _cursorPrev = other._tail;
+                }
+            }
+        }
+        else {
+            Node *prevNode = nullptr;
+            Node *ptr = Seek(position, prevNode);
+
+            other._tail->next = ptr;
+            prevNode->next = other._head;
+
+            // The first spliced node now sits at the cursor position
+            _cursorNode = other._head;
+        }
+
+        _size += other._size;
+        other.Release();
+    }
+
+    /// @brief Function to split the list in two at a specific position.  Runs in the time it takes to
+    /// walk to the position; no element is copied.
+    /// @param position The position of the first element to move to the new list.  May be Size().
+    /// @return A list holding the elements from position to the end.  This list keeps the elements before position.
+    /// @throws LinkedListException if the position is invalid
+    LinkedList SplitAt(int position)
+    {
+        if (position < 0 || position > _size) {
+            throw LinkedListException("Invalid index, SplitAt()");
+        }
+
+        // The nodes move over, so the new list must free them with an allocator equal to ours.
+        LinkedList second{Allocator(_allocator)};
+
+        if (position < _size) {
+            Node *prevNode = nullptr;
+            Node *ptr = Seek(position, prevNode);
+
+            second._head = ptr;
+            second._tail = _tail;
+            second._size = _size - position;
+
+            if (prevNode == nullptr) {
+                Release();
+            }
+            else {
+                prevNode->next = nullptr;
+                _tail = prevNode;
+                _size = position;
+                ResetCursor();
+            }
+        }
+
+        return second;
+    }
+
     /// @brief Function to remove an element at a specific position
     /// @param position The position of the element to remove
     /// @throws LinkedListException if the position is invalid
@@ -126,38 +562,41 @@ public:
             if (position == 0) {
                 Node *oldHead = _head;
                 Node *newHead = _head->next;
-                delete oldHead;
+                DestroyNode(oldHead);
                 _head = newHead;
 
                 _size--;
+
+                if (_head == nullptr) {
+                    _tail = nullptr;
+                    ResetCursor();
+                }
+                else {
+                    SetCursor(0, _head, nullptr);
+                }
             }
             else if (position == _size - 1) {
-                Node *ptr = _head;
-                Node *oldTail = _tail;
                 Node *newTail = nullptr;
-                
-                for (int i = 0; i < position; i++) {
-                    newTail = ptr;
-                    ptr = ptr->next;
-                }
-                delete oldTail;
+                Node *oldTail = Seek(position, newTail);
+
+                DestroyNode(oldTail);
                 _tail = newTail;
                 _tail->next = nullptr;
 
                 _size--;
+                ResetCursor();
             }
             else if (position > 0 && position < _size && position > -1) {
-                Node *ptr = _head;
                 Node *prevNode = nullptr;
-                
-                for (int i = 0; i < position; i++) {
-                    prevNode = ptr;
-                    ptr = ptr->next;
-                }
+                Node *ptr = Seek(position, prevNode);
+
                 prevNode->next = ptr->next;
-                delete ptr;
+                DestroyNode(ptr);
                 
                 _size--;
+
+                // The next node moved up into the cursor position
+                _cursorNode = prevNode->next;
             }
             else throw LinkedListException("Invalid index, RemoveAt()");
         }
@@ -187,72 +626,274 @@ public:
         else return 0;
     }
 
+    /// @brief Function to remove an element at a specific position without throwing on a bad position
+    /// @param position The position of the element to remove
+    /// @return True if the element was removed, false if the position is invalid
+    bool TryRemoveAt(int position)
+    {
+        if (position < 0 || position >= _size) {
+            return false;
+        }
+        RemoveAt(position);
+        return true;
+    }
+
+    /// @brief Removes every element that satisfies a predicate in a single walk of the list.  The removed
+    /// nodes are unlinked during the walk and freed together at the end.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element, in order.  If it throws, the elements removed so
+    /// far stay removed and the exception is passed on.
+    /// @return The number of elements removed
+    template <typename Predicate>
+    int RemoveIf(Predicate pred)
+    {
+        Node *removedHead = nullptr;
+        Node *removedTail = nullptr;
+        Node *prevNode = nullptr;
+        Node *ptr = _head;
+        int removed = 0;
+
+        try
+        {
+            while (ptr) {
+                Node *nextNode = ptr->next;
+
+                if (pred(static_cast<const T &>(ptr->data))) {
+                    if (prevNode) {
+                        prevNode->next = nextNode;
+                    }
+                    else {
+                        _head = nextNode;
+                    }
+                    if (_tail == ptr) {
+                        _tail = prevNode;
+                    }
+                    _size--;
+
+                    ptr->next = nullptr;
+                    if (removedTail) {
+                        removedTail->next = ptr;
+                    }
+                    else {
+                        removedHead = ptr;
+                    }
+                    removedTail = ptr;
+                    removed++;
+                }
+                else {
+                    prevNode = ptr;
+                }
+                ptr = nextNode;
+            }
+        }
+        catch (...)
+        {
+            ResetCursor();
+            DestroyChain(removedHead);
+            throw;
+        }
+
+        ResetCursor();
+        DestroyChain(removedHead);
+        return removed;
+    }
+
+    /// @brief Removes every element equal to a value in a single walk of the list.
+    /// @param value The value to remove
+    /// @return The number of elements removed
+    int RemoveAll(const T &value)
+    {
+        return RemoveIf([&value](const T &element)
+                        { return element == value; });
+    }
+
+    /// @brief Removes a run of consecutive elements.  Walks to the start once, resuming from the cursor,
+    /// unlinks the whole run at once and then frees its nodes.
+    /// @param start The position of the first element to remove
+    /// @param count The number of elements to remove
+    /// @throws LinkedListException if start or count is negative, or the run goes past the end of the list
+    void RemoveRange(int start, int count)
+    {
+        if (!TryRemoveRange(start, count)) {
+            throw LinkedListException("Invalid index, RemoveRange()");
+        }
+    }
+
+    /// @brief Removes a run of consecutive elements without throwing on a bad range
+    /// @param start The position of the first element to remove
+    /// @param count The number of elements to remove
+    /// @return True if the run was removed, false if start or count is negative or the run goes past the end of the list
+    bool TryRemoveRange(int start, int count)
+    {
+        return TryRemoveRange(start, count, [](const T &) {});
+    }
+
+    /// @brief Removes a run of consecutive elements without throwing on a bad range, and calls a function
+    /// with each element of the run during the same walk.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param start The position of the first element to remove
+    /// @param count The number of elements to remove
+    /// @param onRemove Called with each element of the run, in order, before the run is unlinked
+    /// @return True if the run was removed, false if start or count is negative or the run goes past the end of the list
+    template <typename Function>
+    bool TryRemoveRange(int start, int count, Function onRemove)
+    {
+        if (start < 0 || count < 0 || start > _size - count) {
+            return false;
+        }
+        if (count == 0) {
+            return true;
+        }
+
+        Node *prevNode = nullptr;
+        Node *removedHead = Seek(start, prevNode);
+        Node *removedTail = removedHead;
+
+        onRemove(static_cast<const T &>(removedTail->data));
+        for (int i = 1; i < count; i++) {
+            removedTail = removedTail->next;
+            onRemove(static_cast<const T &>(removedTail->data));
+        }
+
+        Node *nextNode = removedTail->next;
+        removedTail->next = nullptr;
+
+        if (prevNode) {
+            prevNode->next = nextNode;
+        }
+        else {
+            _head = nextNode;
+        }
+        if (nextNode == nullptr) {
+            _tail = prevNode;
+        }
+        _size -= count;
+
+        // The element after the run moved up into the start position
+        if (nextNode) {
+            SetCursor(start, nextNode, prevNode);
+        }
+        else {
+            ResetCursor();
+        }
+
+        DestroyChain(removedHead);
+        return true;
+    }
+
     /// @brief Function to clear the linked list
     void Clear()
     { 
         if (_size > 0) {
-            Node *ptr = _head;
-            Node *nodeToDel = nullptr;
-
-            while (ptr) {
-                nodeToDel = ptr;
-                ptr = ptr->next;
-                delete nodeToDel;
-            }
+            DestroyChain(_head);
             _head = nullptr;
             _tail = nullptr;
             _size = 0;
+            ResetCursor();
         }
         else throw LinkedListException("List already empty, Clear()");
     }
 
+    /// @brief Function to clear the linked list without throwing when it is already empty
+    /// @return True if elements were removed, false if the list was already empty
+    bool TryClear()
+    {
+        if (_size == 0) {
+            return false;
+        }
+        Clear();
+        return true;
+    }
+
     /// @brief Function to get the element at a specific position
     /// @param position The position of the element to get
-    /// @return The element at the specified position
+    /// @return A reference to the element at the specified position
     /// @throws LinkedListException if the position is invalid
-    T Get(int position) const
+    T &Get(int position)
     {
         if (_size > 0 && position > -1 && position < _size) {
-            Node *ptr = _head;
-            int i = 0;
-            
-            while (i != position) {
-                i++;
-                ptr = ptr->next;
-            }
+            Node *prevNode = nullptr;
+            Node *ptr = Seek(position, prevNode);
+
             return ptr->data;
         } 
         else throw LinkedListException("Invalid index, Get()");
-        return 0;
     }
 
     /// @brief Function to get the element at a specific position
     /// @param position The position of the element to get
-    /// @return The element at the specified position
+    /// @return A reference to the element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    const T &Get(int position) const
+    {
+        if (_size > 0 && position > -1 && position < _size) {
+            return NodeAt(position)->data;
+        }
+        else throw LinkedListException("Invalid index, Get()");
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return A reference to the element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T &operator[](int position)
+    {
+        return Get(position);
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return A reference to the element at the specified position
     /// @throws LinkedListException if the position is invalid
-    T operator[](int position) const
+    const T &operator[](int position) const
     {
-        Get(position);
+        return Get(position);
+    }
+
+    /// @brief Function to get the element at a specific position without throwing on a bad position.
+    /// A miss only costs the bounds check.
+    /// @param position The position of the element to get
+    /// @param value Set to a copy of the element when the position is valid
+    /// @return True if the position is valid, false otherwise
+    bool TryGet(int position, T &value) const
+    {
+        if (position < 0 || position >= _size) {
+            return false;
+        }
+        value = Get(position);
+        return true;
     }
 
     /// @brief Function to find an element that satisfies a predicate
     /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
     /// @param pred The predicate to apply to each element in the list.  Hint: pred(value) will apply the predicate to the value and return a bool.
-    /// @return The first element that satisfies the predicate
+    /// @return A reference to the first element that satisfies the predicate
     /// @throws LinkedListException if no element satisfies the predicate
     template <typename Predicate>
-    T Find(Predicate pred) const
+    T &Find(Predicate pred)
     {
-        Node *ptr = _head;
+        Node *ptr = FindNode(pred);
 
-        while (ptr) {
-            if (pred(ptr->data)) {
-                return ptr->data;
-            }
-            ptr = ptr->next;
+        if (ptr == nullptr) {
+            throw LinkedListException("Invalid index, Find()");
+        }
+        return ptr->data;
+    }
+
+    /// @brief Function to find an element that satisfies a predicate
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return A reference to the first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    const T &Find(Predicate pred) const
+    {
+        Node *ptr = FindNode(pred);
+
+        if (ptr == nullptr) {
+            throw LinkedListException("Invalid index, Find()");
         }
-        throw LinkedListException("Invalid index, Find()");
-        return 0;
+        return ptr->data;
     }
 
     /// @brief Finds the index of the first element in the list that satisfies the given predicate.
@@ -274,7 +915,191 @@ public:
             ptr = ptr->next;
         }
         throw LinkedListException("Invalid index, FindIndex()");
-        return 0;
+    }
+
+    /// @brief Function to find an element that satisfies a predicate without throwing when there is none
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @param value Set to a copy of the first element that satisfies the predicate
+    /// @return True if an element satisfies the predicate, false otherwise
+    template <typename Predicate>
+    bool TryFind(Predicate pred, T &value) const
+    {
+        for (Node *ptr = _head; ptr; ptr = ptr->next) {
+            if (pred(static_cast<const T &>(ptr->data))) {
+                value = ptr->data;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Finds the index of the first element that satisfies a predicate without throwing when there is none
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @param index Set to the index of the first element that satisfies the predicate
+    /// @return True if an element satisfies the predicate, false otherwise
+    template <typename Predicate>
+    bool TryFindIndex(Predicate pred, int &index) const
+    {
+        int position = 0;
+
+        for (Node *ptr = _head; ptr; ptr = ptr->next) {
+            if (pred(static_cast<const T &>(ptr->data))) {
+                index = position;
+                return true;
+            }
+            position++;
+        }
+        return false;
+    }
+
+    /// @brief Function to find an element equal to a value.  Compares with operator== directly instead of
+    /// going through a predicate.  One element per node leaves nothing to vectorize, UnrolledLinkedList
+    /// has a vectorized version.
+    /// @param value The value to look for
+    /// @return A reference to the first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    T &FindValue(const T &value)
+    {
+        Node *ptr = FindNode([&value](const T &element)
+                             { return element == value; });
+
+        if (ptr == nullptr) {
+            throw LinkedListException("Invalid index, FindValue()");
+        }
+        return ptr->data;
+    }
+
+    /// @brief Function to find an element equal to a value
+    /// @param value The value to look for
+    /// @return A reference to the first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    const T &FindValue(const T &value) const
+    {
+        Node *ptr = FindNode([&value](const T &element)
+                             { return element == value; });
+
+        if (ptr == nullptr) {
+            throw LinkedListException("Invalid index, FindValue()");
+        }
+        return ptr->data;
+    }
+
+    /// @brief Finds the index of the first element equal to a value.
+    /// @param value The value to look for
+    /// @return The index of the first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    int FindIndexOfValue(const T &value) const
+    {
+        Node *ptr = _head;
+        int position = 0;
+
+        while (ptr) {
+            if (ptr->data == value) {
+                return position;
+            }
+            position++;
+            ptr = ptr->next;
+        }
+        throw LinkedListException("Invalid index, FindIndexOfValue()");
+    }
+
+    /// @brief Counts the elements equal to a value.
+    /// @param value The value to count
+    /// @return The number of elements equal to value
+    int Count(const T &value) const
+    {
+        int matches = 0;
+
+        for (Node *ptr = _head; ptr; ptr = ptr->next) {
+            matches += ptr->data == value;
+        }
+        return matches;
+    }
+
+    /// @brief Sorts the list in place by relinking its nodes.  Equal elements keep their order.
+    /// Uses a bottom-up merge sort: O(n log n) comparisons and no memory allocation.
+    /// @tparam Compare The comparison should take two const references to the data type stored in the list
+    /// and return true if the first should come before the second
+    /// @param comp The comparison to sort by.  Defaults to ascending order.
+    template <typename Compare = std::less<T>>
+    void StableSort(Compare comp = Compare())
+    {
+        if (_size < 2) {
+            return;
+        }
+
+        _head = SortChain(_head, comp, _tail);
+        ResetCursor();
+    }
+
+    /// @brief Sorts the list in place by relinking its nodes.  Same as StableSort, since the merge
+    /// sort used is stable anyway.
+    /// @tparam Compare The comparison should take two const references to the data type stored in the list
+    /// and return true if the first should come before the second
+    /// @param comp The comparison to sort by.  Defaults to ascending order.
+    template <typename Compare = std::less<T>>
+    void Sort(Compare comp = Compare())
+    {
+        StableSort(comp);
+    }
+
+    /// @brief Sorts the list in place like StableSort, on a pool of threads.  The list is cut into chunks
+    /// that are sorted in parallel, then neighbouring runs are merged in parallel rounds until one is left.
+    /// Equal elements keep their order.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam Compare The comparison should take two const references to the data type stored in the list
+    /// and return true if the first should come before the second.  It must not throw.
+    /// @param executor The pool to sort on
+    /// @param comp The comparison to sort by.  Defaults to ascending order.
+    template <typename Executor, typename Compare = std::less<T>>
+    void ParallelSort(Executor &executor, Compare comp = Compare())
+    {
+        int chunkSize = 0;
+        std::vector<Node *> heads = ChunkBoundaries(executor.Size(), chunkSize);
+
+        if (heads.size() < 2) {
+            StableSort(comp);
+            return;
+        }
+
+        // Every chunk is cut off from the next one and sorted on its own.  A chunk only touches its own
+        // nodes, so the chunks can be cut and sorted at the same time.
+        std::vector<Node *> tails(heads.size(), nullptr);
+
+        executor.ParallelFor(static_cast<int>(heads.size()), [&](int chunk)
+                             {
+                                 Node *last = heads[chunk];
+                                 for (int i = 1; i < chunkSize && last->next; i++) {
+                                     last = last->next;
+                                 }
+                                 last->next = nullptr;
+
+                                 heads[chunk] = SortChain(heads[chunk], comp, tails[chunk]); });
+
+        // Merge runs 2k and 2k + 1 of every round into run k of the next one, which keeps earlier
+        // elements first.  An odd run out is carried over as it is.
+        while (heads.size() > 1) {
+            int pairs = static_cast<int>(heads.size() / 2);
+            std::vector<Node *> mergedHeads((heads.size() + 1) / 2, heads.back());
+            std::vector<Node *> mergedTails((tails.size() + 1) / 2, tails.back());
+
+            executor.ParallelFor(pairs, [&](int pair)
+                                 {
+                                     Node *firstTail = tails[2 * pair];
+                                     Node *secondTail = tails[2 * pair + 1];
+
+                                     mergedHeads[pair] = MergeRuns(heads[2 * pair], heads[2 * pair + 1], comp);
+                                     mergedTails[pair] = comp(secondTail->data, firstTail->data) ? firstTail : secondTail; });
+
+            heads.swap(mergedHeads);
+            tails.swap(mergedTails);
+        }
+
+        _head = heads.front();
+        _tail = tails.front();
+        ResetCursor();
     }
 
     /// @brief Applies a function to each element of the linked list.
@@ -291,6 +1116,177 @@ public:
         }
     }
 
+    /// @brief Applies a function to each element of the linked list, spreading the work over a pool of threads.
+    /// The list is cut into chunks at boundary nodes found in one walk, and each chunk runs as one task.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param executor The pool to run the chunks on
+    /// @param func The function to apply.  Called from several threads at once and in no particular order.
+    template <typename Executor, typename Function>
+    void ForEach(Executor &executor, Function func) const
+    {
+        int chunkSize = 0;
+        std::vector<Node *> boundaries = ChunkBoundaries(executor.Size(), chunkSize);
+
+        executor.ParallelFor(static_cast<int>(boundaries.size()), [&](int chunk)
+                             {
+                                 Node *ptr = boundaries[chunk];
+                                 for (int i = 0; i < chunkSize && ptr; i++) {
+                                     func(static_cast<const T &>(ptr->data));
+                                     ptr = ptr->next;
+                                 } });
+    }
+
+    /// @brief Function to find an element that satisfies a predicate, searching chunks of the list in parallel.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param executor The pool to run the search on
+    /// @param pred The predicate to apply.  Called from several threads at once.
+    /// @return A reference to the first element that satisfies the predicate, the same one the sequential Find returns
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Executor, typename Predicate>
+    const T &Find(Executor &executor, Predicate pred) const
+    {
+        int index = 0;
+        Node *node = ParallelFindNode(executor, pred, index);
+
+        if (node == nullptr) {
+            throw LinkedListException("Invalid index, Find()");
+        }
+        return node->data;
+    }
+
+    /// @brief Finds the lowest index of an element that satisfies a predicate, searching chunks of the list in parallel.
+    /// Once a match is found, chunks after it stop early or are skipped.
+    /// @tparam Executor A pool with Size() and ParallelFor(count, func), such as ThreadPool
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param executor The pool to run the search on
+    /// @param pred The predicate to apply.  Called from several threads at once.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Executor, typename Predicate>
+    int FindIndex(Executor &executor, Predicate pred) const
+    {
+        int index = 0;
+
+        if (ParallelFindNode(executor, pred, index) == nullptr) {
+            throw LinkedListException("Invalid index, FindIndex()");
+        }
+        return index;
+    }
+
+    /// @brief Returns an iterator to the first element, or end() if the list is empty.
+    iterator begin()
+    {
+        return iterator(_head);
+    }
+
+    /// @brief Returns an iterator one past the last element.
+    iterator end()
+    {
+        return iterator(nullptr);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(_head);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(nullptr);
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// @brief Starts a lazy pipeline over the elements, such as View().Filter(pred).Map(func).Reduce(init, op).
+    /// The stages run fused in a single walk of the list when a terminal operation is called.  See listview.hpp.
+    /// @return A view of every element of the list
+    ListView<ListSource<LinkedList>> View() const
+    {
+        return MakeListView(*this);
+    }
+
+    /// @brief Function to insert a new element right after the element an iterator points to.  Runs in O(1).
+    /// @param position Iterator to the element to insert after.  Must not be end().
+    /// @param value The value to be inserted
+    /// @return An iterator to the new element
+    /// @throws LinkedListException if position is end()
+    iterator InsertAfter(const_iterator position, const T &value)
+    {
+        return EmplaceAfter(position, value);
+    }
+
+    /// @brief Function to insert a new element right after the element an iterator points to.  Runs in O(1).
+    /// @param position Iterator to the element to insert after.  Must not be end().
+    /// @param value The value to be moved into the list
+    /// @return An iterator to the new element
+    /// @throws LinkedListException if position is end()
+    iterator InsertAfter(const_iterator position, T &&value)
+    {
+        return EmplaceAfter(position, std::move(value));
+    }
+
+    /// @brief Function to construct a new element in place right after the element an iterator points to.  Runs in O(1).
+    /// @param position Iterator to the element to insert after.  Must not be end().
+    /// @param args The arguments to pass to the constructor of the element
+    /// @return An iterator to the new element
+    /// @throws LinkedListException if position is end()
+    template <typename... Args>
+    iterator EmplaceAfter(const_iterator position, Args &&...args)
+    {
+        Node *prevNode = position._node;
+
+        if (prevNode == nullptr) {
+            throw LinkedListException("Invalid iterator, InsertAfter()");
+        }
+
+        Node *newNode = CreateNode(std::forward<Args>(args)...);
+        newNode->next = prevNode->next;
+        prevNode->next = newNode;
+
+        if (_tail == prevNode) {
+            _tail = newNode;
+        }
+        _size++;
+        ResetCursor();
+
+        return iterator(newNode);
+    }
+
+    /// @brief Function to remove the element right after the element an iterator points to.  Runs in O(1).
+    /// @param position Iterator to the element before the one to remove
+    /// @return An iterator to the element that followed the removed one, or end()
+    /// @throws LinkedListException if position is end() or the last element
+    iterator EraseAfter(const_iterator position)
+    {
+        Node *prevNode = position._node;
+
+        if (prevNode == nullptr || prevNode->next == nullptr) {
+            throw LinkedListException("Invalid iterator, EraseAfter()");
+        }
+
+        Node *nodeToDel = prevNode->next;
+        prevNode->next = nodeToDel->next;
+
+        if (_tail == nodeToDel) {
+            _tail = prevNode;
+        }
+        DestroyNode(nodeToDel);
+        _size--;
+        ResetCursor();
+
+        return iterator(prevNode->next);
+    }
+
 private:
     /// @brief Node class
     class Node
@@ -299,11 +1295,339 @@ private:
         T data;     ///< The data stored in the node
         Node *next; ///< Pointer to the next node
 
-        /// @brief Constructor that copies the value into the node.  Template type must support copy constructor.
-        /// @param value The value to be copied into the node
-        Node(const T &value) : data(value), next(nullptr) {}
+        /// @brief Constructor that builds the value in place from the given arguments.
+        /// @param args The arguments to pass to the constructor of the value, for example a value to copy or move
+        template <typename... Args>
+        Node(Args &&...args) : data(std::forward<Args>(args)...), next(nullptr) {}
     };
 
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+
+    /// @brief Allocates a node from the node allocator and constructs the value in it.
+    /// @param args The arguments to pass to the constructor of the value
+    /// @return The new node, not yet linked into the list
+    template <typename... Args>
+    Node *CreateNode(Args &&...args)
+    {
+        Node *node = NodeAllocatorTraits::allocate(_allocator, 1);
+
+        try
+        {
+            NodeAllocatorTraits::construct(_allocator, node, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            NodeAllocatorTraits::deallocate(_allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    /// @brief Builds an unlinked chain of nodes from a range of values.
+    /// If constructing any value throws, the nodes built so far are freed, chainHead and chainTail are set
+    /// to nullptr and the exception is rethrown.
+    /// @param first The beginning of the range
+    /// @param last The end of the range
+    /// @param chainHead Set to the first node of the chain, or nullptr for an empty range
+    /// @param chainTail Set to the last node of the chain, or nullptr for an empty range
+    /// @return The number of nodes in the chain
+    template <typename InputIterator>
+    int BuildChain(InputIterator first, InputIterator last, Node *&chainHead, Node *&chainTail)
+    {
+        int count = 0;
+        Node *head = nullptr;
+        Node *tail = nullptr;
+        chainHead = nullptr;
+        chainTail = nullptr;
+
+        try
+        {
+            for (; first != last; ++first)
+            {
+                Node *newNode = CreateNode(*first);
+
+                if (tail == nullptr) {
+                    head = newNode;
+                }
+                else {
+                    tail->next = newNode;
+                }
+                tail = newNode;
+                count++;
+            }
+        }
+        catch (...)
+        {
+            // Built on the side, so the caller never holds a pointer into the chain freed here.
+            DestroyChain(head);
+            throw;
+        }
+
+        chainHead = head;
+        chainTail = tail;
+        return count;
+    }
+
+    /// @brief Destroys a node and returns its memory to the node allocator.
+    /// @param node The node to destroy, already unlinked from the list
+    void DestroyNode(Node *node)
+    {
+        NodeAllocatorTraits::destroy(_allocator, node);
+        NodeAllocatorTraits::deallocate(_allocator, node, 1);
+    }
+
+    /// @brief Destroys a chain of nodes that is already unlinked from the list, in one sweep.
+    /// @param chainHead The first node of the chain, or nullptr for an empty chain
+    void DestroyChain(Node *chainHead)
+    {
+        while (chainHead) {
+            Node *nodeToDel = chainHead;
+            chainHead = chainHead->next;
+            DestroyNode(nodeToDel);
+        }
+    }
+
+    /// @brief Walks to a position, resuming from the cursor when the position is at or after it.
+    /// Leaves the cursor at the position.  Only for non-const functions, so const reads never write to the
+    /// list and stay safe to call from several threads at once.
+    /// @param position The position to walk to.  Must be a valid position.
+    /// @param prevNode Set to the node before the position, or nullptr for the head
+    /// @return The node at the position
+    Node *Seek(int position, Node *&prevNode)
+    {
+        Node *ptr = _head;
+        int i = 0;
+        prevNode = nullptr;
+
+        if (_cursorNode != nullptr && _cursorIndex <= position) {
+            ptr = _cursorNode;
+            prevNode = _cursorPrev;
+            i = _cursorIndex;
+        }
+
+        for (; i < position; i++) {
+            prevNode = ptr;
+            ptr = ptr->next;
+        }
+
+        SetCursor(position, ptr, prevNode);
+        return ptr;
+    }
+
+    /// @brief Walks to a position from the head without using or moving the cursor, for const functions.
+    /// @param position The position to walk to.  Must be a valid position.
+    /// @return The node at the position
+    Node *NodeAt(int position) const
+    {
+        Node *ptr = _head;
+
+        for (int i = 0; i < position; i++) {
+            ptr = ptr->next;
+        }
+        return ptr;
+    }
+
+    /// @brief Finds the first node whose element satisfies a predicate.
+    /// @param pred The predicate to apply to each element in order
+    /// @return The node, or nullptr if no element satisfies the predicate
+    template <typename Predicate>
+    Node *FindNode(Predicate pred) const
+    {
+        for (Node *ptr = _head; ptr; ptr = ptr->next) {
+            if (pred(static_cast<const T &>(ptr->data))) {
+                return ptr;
+            }
+        }
+        return nullptr;
+    }
+
+    void SetCursor(int index, Node *node, Node *prevNode)
+    {
+        _cursorIndex = index;
+        _cursorNode = node;
+        _cursorPrev = prevNode;
+    }
+
+    /// @brief Picks the chunk size for the parallel algorithms: a few chunks per thread so an uneven
+    /// workload still balances, but not so small that handing out a chunk costs more than working on it.
+    /// @param threads The number of threads the chunks will run on
+    /// @param count The number of elements to split up
+    /// @return The number of elements per chunk
+    static int ParallelChunkSize(int threads, int count)
+    {
+        const int chunksPerThread = 4;
+        const int minChunkSize = 1024;
+
+        int chunks = std::max(1, threads * chunksPerThread);
+        return std::max(minChunkSize, (count + chunks - 1) / chunks);
+    }
+
+    /// @brief Splits the list into chunks for the parallel algorithms.
+    /// @param threads The number of threads the chunks will run on
+    /// @param chunkSize Set to the number of elements per chunk.  The last chunk may be shorter.
+    /// @return The first node of every chunk
+    std::vector<Node *> ChunkBoundaries(int threads, int &chunkSize) const
+    {
+        chunkSize = ParallelChunkSize(threads, _size);
+
+        std::vector<Node *> boundaries;
+        int i = 0;
+
+        for (Node *ptr = _head; ptr; ptr = ptr->next, i++) {
+            if (i % chunkSize == 0) {
+                boundaries.push_back(ptr);
+            }
+        }
+        return boundaries;
+    }
+
+    /// @brief Searches the chunks of the list in parallel for the first element that satisfies a predicate.
+    /// @param index Set to the index of the match
+    /// @return The matching node with the lowest index, or nullptr if there is none
+    template <typename Executor, typename Predicate>
+    Node *ParallelFindNode(Executor &executor, Predicate &pred, int &index) const
+    {
+        int chunkSize = 0;
+        std::vector<Node *> boundaries = ChunkBoundaries(executor.Size(), chunkSize);
+        std::vector<Node *> matches(boundaries.size(), nullptr);
+        std::atomic<int> best(INT_MAX);
+
+        executor.ParallelFor(static_cast<int>(boundaries.size()), [&](int chunk)
+                             {
+                                 Node *ptr = boundaries[chunk];
+                                 int position = chunk * chunkSize;
+
+                                 for (int i = 0; i < chunkSize && ptr; i++, position++) {
+                                     // Give up once an earlier chunk has a match, checking only now and then.
+                                     if (i % 64 == 0 && best.load(std::memory_order_relaxed) < position) {
+                                         return;
+                                     }
+                                     if (pred(static_cast<const T &>(ptr->data))) {
+                                         matches[chunk] = ptr;
+
+                                         int current = best.load();
+                                         while (position < current && !best.compare_exchange_weak(current, position)) {
+                                         }
+                                         return;
+                                     }
+                                     ptr = ptr->next;
+                                 } });
+
+        index = best.load();
+        return index == INT_MAX ? nullptr : matches[index / chunkSize];
+    }
+
+    /// @brief Merges two sorted, null terminated chains of nodes.  On ties nodes from first come first.
+    /// @param first The chain holding the earlier elements
+    /// @param second The chain holding the later elements
+    /// @param comp The comparison the chains are sorted by
+    /// @return The head of the merged chain
+    template <typename Compare>
+    static Node *MergeRuns(Node *first, Node *second, Compare &comp)
+    {
+        Node *merged = nullptr;
+        Node **link = &merged;
+
+        while (first && second) {
+            if (comp(second->data, first->data)) {
+                *link = second;
+                second = second->next;
+            }
+            else {
+                *link = first;
+                first = first->next;
+            }
+            link = &(*link)->next;
+        }
+        *link = first ? first : second;
+
+        return merged;
+    }
+
+    /// @brief Sorts a null terminated chain of nodes with a bottom-up merge sort.
+    /// @param chain The first node of the chain.  Must not be null.
+    /// @param comp The comparison to sort by
+    /// @param sortedTail Set to the last node of the sorted chain
+    /// @return The first node of the sorted chain
+    template <typename Compare>
+    static Node *SortChain(Node *chain, Compare &comp, Node *&sortedTail)
+    {
+        // runs[i] is either empty or a sorted run of 2^i nodes.  Runs in higher slots hold earlier
+        // elements, which is what keeps the sort stable.
+        const int maxRuns = 64;
+        Node *runs[maxRuns] = {};
+        Node *ptr = chain;
+
+        while (ptr) {
+            Node *run = ptr;
+            ptr = ptr->next;
+            run->next = nullptr;
+
+            int i = 0;
+            for (; i < maxRuns - 1 && runs[i] != nullptr; i++) {
+                run = MergeRuns(runs[i], run, comp);
+                runs[i] = nullptr;
+            }
+            runs[i] = run;
+        }
+
+        Node *sorted = nullptr;
+        for (int i = 0; i < maxRuns; i++) {
+            if (runs[i] != nullptr) {
+                sorted = MergeRuns(runs[i], sorted, comp);
+            }
+        }
+
+        sortedTail = sorted;
+        while (sortedTail->next) {
+            sortedTail = sortedTail->next;
+        }
+        return sorted;
+    }
+
+    /// @brief Links a chain of new nodes in after the tail.
+    /// @param chainHead The first node of the chain, or nullptr for an empty chain
+    /// @param chainTail The last node of the chain
+    /// @param count The number of nodes in the chain
+    void AttachChain(Node *chainHead, Node *chainTail, int count)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        if (_size > 0) {
+            _tail->next = chainHead;
+        }
+        else {
+            _head = chainHead;
+        }
+        _tail = chainTail;
+        _size += count;
+    }
+
+    /// @brief Empties the list without freeing any node, after its nodes were handed to another list.
+    void Release()
+    {
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+        ResetCursor();
+    }
+
+    /// @brief Forgets the cursor.  Must be called by any change that could leave it pointing at a freed node.
+    void ResetCursor()
+    {
+        SetCursor(0, nullptr, nullptr);
+    }
+
+    NodeAllocator _allocator; ///< Allocator used for every node in the list
+
+    // Cursor left behind by the last positional walk of a non-const function.  Const reads leave it alone.
+    int _cursorIndex;   ///< The position of _cursorNode
+    Node *_cursorNode;  ///< The node at _cursorIndex, or nullptr when there is no cursor
+    Node *_cursorPrev;  ///< The node before _cursorNode, or nullptr when _cursorNode is the head
+
     Node *_head; ///< Pointer to the first node
     Node *_tail; ///< Pointer to the last node
     int _size;   ///< The number of elements in the list
@@ -1,3 +1,5 @@
+#include <climits>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -5,13 +7,18 @@
 
 #include "linkedlist.hpp"
 #include "linkedlisttest.hpp"
+#include "threadpool.hpp"
 
 using namespace std;
 
 bool TestAppend(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestAppendMany(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestPrepend(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestInsert(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestRemove(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestRemoveIf(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestRemoveRange(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestRemoveAll(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestGet(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestSize(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestClear(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
@@ -20,12 +27,23 @@ bool TestFind(const std::vector<std::string> &params, std::string &output, bool
 bool TestFindIndex(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestForeach(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 bool TestPrint(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestSort(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestParallelSort(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestSum(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestCount(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestMin(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestMax(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
+bool TestFirst(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine);
 
 vector<TestFunctionEntry> linkedListTestCommands = {
     {"append", "append <value>", TestAppend},
+    {"appendmany", "appendmany <value> [value...]", TestAppendMany},
     {"prepend", "prepend <value>", TestPrepend},
     {"insertat", "insertat <value> <position>", TestInsert},
     {"removeat", "removeat <value> <position>", TestRemove},
+    {"removeif", "removeif <lt|le|gt|ge|eq|ne> <value> - removes the matching elements and prints how many", TestRemoveIf},
+    {"removerange", "removerange <start> <count>", TestRemoveRange},
+    {"removeall", "removeall <value> - removes the elements equal to value and prints how many", TestRemoveAll},
     {"size", "size", TestSize},
     {"empty", "empty", TestEmpty},
     {"clear", "clear", TestClear},
@@ -36,9 +54,63 @@ vector<TestFunctionEntry> linkedListTestCommands = {
     {"findindex", "findindex <value>", TestFindIndex},
     {"foreach", "foreach", TestForeach},
     {"print", "print", TestPrint},
+    {"sort", "sort [asc|desc]", TestSort},
+    {"psort", "psort [asc|desc] - sorts on the thread pool", TestParallelSort},
+    {"sum", "sum", TestSum},
+    {"count", "count [value] - counts every element, or the elements equal to value", TestCount},
+    {"min", "min", TestMin},
+    {"max", "max", TestMax},
+    {"first", "first <count> - prints the first count elements", TestFirst},
 };
 
-LinkedList<int> myNameList;
+/// @brief The session a thread is in, or nullptr for the repl's session.
+static TestSession *&CurrentSession()
+{
+    static thread_local TestSession *session = nullptr;
+    return session;
+}
+
+TestSession::TestSession() : _previous(CurrentSession())
+{
+    CurrentSession() = this;
+}
+
+TestSession::~TestSession()
+{
+    CurrentSession() = _previous;
+}
+
+TestSession &TestSession::Current()
+{
+    if (CurrentSession() == nullptr)
+    {
+        // Leaked so it outlives any command run while statics are being destroyed.  It is never the
+        // current session of a thread, so creating it must not leave it current.
+        static TestSession *replSession = []()
+        {
+            TestSession *session = new TestSession();
+            CurrentSession() = session->_previous;
+            return session;
+        }();
+        return *replSession;
+    }
+    return *CurrentSession();
+}
+
+/// @brief Reports a lookup or edit that missed, the same way ProcessCommand reports a LinkedListException.
+/// The commands use the Try functions, so a miss costs no exception.
+static bool ReportMiss(std::string &output, int currentLine, const std::string &message)
+{
+    PrintError(currentLine, 0, "LinkedList Error: " + message);
+    output = "error";
+    return true;
+}
+
+/// @brief The list of the current session.
+static IndexedByValueLinkedList<int> &SessionList()
+{
+    return TestSession::Current().list;
+}
 
 bool TestAppend(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
 {
@@ -47,7 +119,25 @@ bool TestAppend(const std::vector<std::string> &params, std::string &output, boo
         throw invalid_argument("append requires 1 parameter");
     }
 
-    myNameList.Append(stoi(params[0]));
+    SessionList().Append(stoi(params[0]));
+    output = "";
+    return true;
+}
+
+bool TestAppendMany(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() < 1)
+    {
+        throw invalid_argument("appendmany requires at least 1 parameter");
+    }
+
+    vector<int> values;
+    for (const string &param : params)
+    {
+        values.push_back(stoi(param));
+    }
+
+    SessionList().AppendRange(values.begin(), values.end());
     output = "";
     return true;
 }
@@ -59,7 +149,7 @@ bool TestPrepend(const std::vector<std::string> &params, std::string &output, bo
         throw invalid_argument("prepend requires 1 parameter");
     }
 
-    myNameList.Prepend(stoi(params[0]));
+    SessionList().Prepend(stoi(params[0]));
     output = "";
     return true;
 }
@@ -71,7 +161,7 @@ bool TestInsert(const std::vector<std::string> &params, std::string &output, boo
         throw invalid_argument("insertat requires 2 parameters");
     }
 
-    myNameList.InsertAt(stoi(params[0]), stoi(params[1]));
+    SessionList().InsertAt(stoi(params[0]), stoi(params[1]));
     output = "";
     return true;
 }
@@ -83,7 +173,10 @@ bool TestRemove(const std::vector<std::string> &params, std::string &output, boo
         throw invalid_argument("removeat requires 1 parameter");
     }
 
-    myNameList.RemoveAt(stoi(params[0]));
+    if (!SessionList().TryRemoveAt(stoi(params[0])))
+    {
+        return ReportMiss(output, currentLine, SessionList().Empty() ? "RemoveAt() cannot be called on an empty list" : "Invalid index, RemoveAt()");
+    }
     output = "";
     return true;
 }
@@ -95,7 +188,12 @@ bool TestGet(const std::vector<std::string> &params, std::string &output, bool i
         throw invalid_argument("get requires 1 parameter");
     }
 
-    output = to_string(myNameList.Get(stoi(params[0])));
+    int value;
+    if (!SessionList().TryGet(stoi(params[0]), value))
+    {
+        return ReportMiss(output, currentLine, "Invalid index, Get()");
+    }
+    output = to_string(value);
 
     return true;
 }
@@ -107,7 +205,7 @@ bool TestSize(const std::vector<std::string> &params, std::string &output, bool
         throw invalid_argument("size does not take any parameters");
     }
 
-    output = to_string(myNameList.Size());
+    output = to_string(SessionList().Size());
 
     return true;
 }
@@ -119,7 +217,10 @@ bool TestClear(const std::vector<std::string> &params, std::string &output, bool
         throw std::invalid_argument("clear does not take any parameters");
     }
 
-    myNameList.Clear();
+    if (!SessionList().TryClear())
+    {
+        return ReportMiss(output, currentLine, "List already empty, Clear()");
+    }
     output = "";
 
     return true;
@@ -132,7 +233,7 @@ bool TestEmpty(const std::vector<std::string> &params, std::string &output, bool
         throw std::invalid_argument("empty does not take any parameters");
     }
 
-    output = to_string(myNameList.Empty());
+    output = to_string(SessionList().Empty());
 
     return true;
 }
@@ -144,11 +245,12 @@ bool TestFind(const std::vector<std::string> &params, std::string &output, bool
         throw std::invalid_argument("find requires 1 parameter");
     }
 
-    int valueToFind = stoi(params[0]);
-    auto predicate = [valueToFind](const int &value)
-    { return value == valueToFind; };
-
-    output = to_string(myNameList.Find(predicate));
+    int value;
+    if (!SessionList().TryFindValue(stoi(params[0]), value))
+    {
+        return ReportMiss(output, currentLine, "Invalid index, FindValue()");
+    }
+    output = to_string(value);
 
     return true;
 }
@@ -160,11 +262,12 @@ bool TestFindIndex(const std::vector<std::string> &params, std::string &output,
         throw std::invalid_argument("findindex requires 1 parameter");
     }
 
-    int valueToFind = stoi(params[0]);
-    auto predicate = [valueToFind](int value)
-    { return value == valueToFind; };
-
-    output = to_string(myNameList.FindIndex(predicate));
+    int index;
+    if (!SessionList().TryFindIndexOfValue(stoi(params[0]), index))
+    {
+        return ReportMiss(output, currentLine, "Invalid index, FindIndexOfValue()");
+    }
+    output = to_string(index);
 
     return true;
 }
@@ -177,7 +280,7 @@ bool TestForeach(const std::vector<std::string> &params, std::string &output, bo
     }
 
     output = "";
-    myNameList.ForEach([&output](int value)
+    SessionList().ForEach([&output](int value)
                        { output.append(to_string(value) + ","); });
 
     return true;
@@ -191,8 +294,224 @@ bool TestPrint(const std::vector<std::string> &params, std::string &output, bool
     }
 
     output = "";
-    myNameList.ForEach([&output](int value)
+    SessionList().ForEach([&output](int value)
                        { output.append(to_string(value) + ","); });
 
     return true;
 }
+
+bool TestSort(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() > 1)
+    {
+        throw std::invalid_argument("sort takes at most 1 parameter");
+    }
+
+    if (params.empty() || params[0] == "asc")
+    {
+        SessionList().Sort();
+    }
+    else if (params[0] == "desc")
+    {
+        SessionList().Sort(std::greater<int>());
+    }
+    else
+    {
+        throw std::invalid_argument("sort order must be asc or desc");
+    }
+
+    output = "";
+    return true;
+}
+
+bool TestParallelSort(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() > 1)
+    {
+        throw std::invalid_argument("psort takes at most 1 parameter");
+    }
+
+    if (params.empty() || params[0] == "asc")
+    {
+        SessionList().ParallelSort(ThreadPool::Default());
+    }
+    else if (params[0] == "desc")
+    {
+        SessionList().ParallelSort(ThreadPool::Default(), std::greater<int>());
+    }
+    else
+    {
+        throw std::invalid_argument("psort order must be asc or desc");
+    }
+
+    output = "";
+    return true;
+}
+
+bool TestSum(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 0)
+    {
+        throw std::invalid_argument("sum does not take any parameters");
+    }
+
+    long long sum = SessionList().View().Reduce(0LL, [](long long total, int value)
+                                                { return total + value; });
+    output = to_string(sum);
+
+    return true;
+}
+
+bool TestCount(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() > 1)
+    {
+        throw std::invalid_argument("count takes at most 1 parameter");
+    }
+
+    if (params.empty())
+    {
+        output = to_string(SessionList().View().Count());
+    }
+    else
+    {
+        int match = stoi(params[0]);
+        output = to_string(SessionList().View().Filter([match](int value)
+                                                       { return value == match; })
+                               .Count());
+    }
+
+    return true;
+}
+
+bool TestMin(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 0)
+    {
+        throw std::invalid_argument("min does not take any parameters");
+    }
+
+    if (SessionList().Empty())
+    {
+        return ReportMiss(output, currentLine, "List is empty, Min()");
+    }
+    output = to_string(SessionList().View().Reduce(INT_MAX, [](int least, int value)
+                                                   { return value < least ? value : least; }));
+
+    return true;
+}
+
+bool TestMax(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 0)
+    {
+        throw std::invalid_argument("max does not take any parameters");
+    }
+
+    if (SessionList().Empty())
+    {
+        return ReportMiss(output, currentLine, "List is empty, Max()");
+    }
+    output = to_string(SessionList().View().Reduce(INT_MIN, [](int greatest, int value)
+                                                   { return value > greatest ? value : greatest; }));
+
+    return true;
+}
+
+bool TestFirst(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 1)
+    {
+        throw std::invalid_argument("first requires 1 parameter");
+    }
+
+    int count = stoi(params[0]);
+    if (count < 0)
+    {
+        throw std::invalid_argument("first count must not be negative");
+    }
+
+    LinkedList<string> taken;
+    SessionList().View().Take(count).Map([](int value)
+                                         { return to_string(value) + ","; })
+        .CollectInto(taken);
+
+    output = "";
+    taken.ForEach([&output](const string &value)
+                  { output.append(value); });
+
+    return true;
+}
+
+bool TestRemoveIf(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 2)
+    {
+        throw std::invalid_argument("removeif requires 2 parameters");
+    }
+
+    const string &op = params[0];
+    int operand = stoi(params[1]);
+    function<bool(int)> pred;
+
+    if (op == "lt")
+    {
+        pred = [operand](int value) { return value < operand; };
+    }
+    else if (op == "le")
+    {
+        pred = [operand](int value) { return value <= operand; };
+    }
+    else if (op == "gt")
+    {
+        pred = [operand](int value) { return value > operand; };
+    }
+    else if (op == "ge")
+    {
+        pred = [operand](int value) { return value >= operand; };
+    }
+    else if (op == "eq")
+    {
+        pred = [operand](int value) { return value == operand; };
+    }
+    else if (op == "ne")
+    {
+        pred = [operand](int value) { return value != operand; };
+    }
+    else
+    {
+        throw std::invalid_argument("removeif comparison must be lt, le, gt, ge, eq or ne");
+    }
+
+    output = to_string(SessionList().RemoveIf(pred));
+
+    return true;
+}
+
+bool TestRemoveRange(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 2)
+    {
+        throw std::invalid_argument("removerange requires 2 parameters");
+    }
+
+    if (!SessionList().TryRemoveRange(stoi(params[0]), stoi(params[1])))
+    {
+        return ReportMiss(output, currentLine, "Invalid index, RemoveRange()");
+    }
+    output = "";
+
+    return true;
+}
+
+bool TestRemoveAll(const std::vector<std::string> &params, std::string &output, bool interactive, int currentLine)
+{
+    if (params.size() != 1)
+    {
+        throw std::invalid_argument("removeall requires 1 parameter");
+    }
+
+    output = to_string(SessionList().RemoveAll(stoi(params[0])));
+
+    return true;
+}
@@ -1,5 +1,31 @@
 #pragma once
 
 #include "helpers.hpp"
+#include "indexedbyvaluelinkedlist.hpp"
 
 extern std::vector<TestFunctionEntry> linkedListTestCommands;
+
+/// @brief The state the list test commands work on.  Every test file runs in a session of its own, so
+/// files can run side by side on different threads without seeing each other's list.
+class TestSession
+{
+public:
+    /// @brief Constructor - makes the new, empty session the current one of the calling thread.
+    TestSession();
+
+    /// @brief Destructor - makes the session that was current before this one current again.
+    ~TestSession();
+
+    TestSession(const TestSession &) = delete;
+    TestSession &operator=(const TestSession &) = delete;
+
+    /// @brief Function to get the current session of the calling thread.  A thread that has not
+    /// created one uses the session of the interactive repl.
+    /// @return The current session
+    static TestSession &Current();
+
+    IndexedByValueLinkedList<int> list; ///< The list the commands work on, indexed so find is O(1)
+
+private:
+    TestSession *_previous; ///< The session that was current when this one was created
+};
@@ -0,0 +1,241 @@
+/// @file listview.hpp
+/// @brief Lazy Filter/Map/Take/Reduce pipelines over a list, fused into a single traversal
+/// @details list.View() starts a pipeline and every stage added to it just wraps the one before, so
+/// nothing runs until a terminal operation such as Reduce, Count or CollectInto is called.  The terminal
+/// operation walks the list once and pushes every element through all stages in turn, so no stage
+/// stores its results in an intermediate container.
+///
+/// Each stage is a source with a Push(sink) function that calls sink(value) for each of its values and
+/// stops as soon as the sink returns false, which is how Take ends the walk early.  The stages are plain
+/// templates, so the compiler can inline the whole pipeline into one loop.
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+/// @brief The first stage of a pipeline: the elements of a list, in order
+/// @tparam List A list with const begin() and end()
+template <typename List>
+class ListSource
+{
+public:
+    typedef typename std::decay<decltype(*std::declval<const List &>().begin())>::type value_type;
+
+    explicit ListSource(const List &list) : _list(list) {}
+
+    /// @brief Calls sink with every element until it returns false.
+    /// @return False if the sink stopped the walk
+    template <typename Sink>
+    bool Push(Sink &sink) const
+    {
+        for (auto it = _list.begin(); it != _list.end(); ++it)
+        {
+            if (!sink(*it))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const List &_list; ///< The list to walk
+};
+
+/// @brief A stage that only passes on the values that satisfy a predicate
+template <typename Source, typename Predicate>
+class FilterStage
+{
+public:
+    typedef typename Source::value_type value_type;
+
+    FilterStage(const Source &source, Predicate pred) : _source(source), _pred(pred) {}
+
+    template <typename Sink>
+    bool Push(Sink &sink) const
+    {
+        const Predicate &pred = _pred;
+        auto filtered = [&pred, &sink](const value_type &value)
+        {
+            return !pred(value) || sink(value);
+        };
+        return _source.Push(filtered);
+    }
+
+private:
+    Source _source;  ///< The stage before this one
+    Predicate _pred; ///< Whether a value is passed on
+};
+
+/// @brief A stage that passes on the result of a function applied to every value
+template <typename Source, typename Function>
+class MapStage
+{
+public:
+    typedef typename Source::value_type input_type;
+    typedef typename std::decay<decltype(std::declval<const Function &>()(std::declval<const input_type &>()))>::type value_type;
+
+    MapStage(const Source &source, Function func) : _source(source), _func(func) {}
+
+    template <typename Sink>
+    bool Push(Sink &sink) const
+    {
+        const Function &func = _func;
+        auto mapped = [&func, &sink](const input_type &value)
+        {
+            return sink(func(value));
+        };
+        return _source.Push(mapped);
+    }
+
+private:
+    Source _source;  ///< The stage before this one
+    Function _func;  ///< The function to apply
+};
+
+/// @brief A stage that passes on the first count values and then stops the walk
+template <typename Source>
+class TakeStage
+{
+public:
+    typedef typename Source::value_type value_type;
+
+    TakeStage(const Source &source, int count) : _source(source), _count(count) {}
+
+    template <typename Sink>
+    bool Push(Sink &sink) const
+    {
+        int remaining = _count;
+
+        if (remaining <= 0)
+        {
+            return true;
+        }
+
+        auto taken = [&remaining, &sink](const value_type &value)
+        {
+            remaining--;
+            return sink(value) && remaining > 0;
+        };
+        return _source.Push(taken);
+    }
+
+private:
+    Source _source; ///< The stage before this one
+    int _count;     ///< The number of values to pass on
+};
+
+/// @brief A lazy pipeline over a list.  Adding a stage returns a new view, and only the terminal operations
+/// (ForEach, Reduce, Count, CollectInto) walk the list.  A view holds a reference to its list, which must
+/// outlive it and must not change while a terminal operation runs.
+/// @tparam Source The last stage of the pipeline
+template <typename Source>
+class ListView
+{
+public:
+    typedef typename Source::value_type value_type;
+
+    explicit ListView(const Source &source) : _source(source) {}
+
+    /// @brief Adds a stage that only keeps the values that satisfy a predicate.
+    /// @tparam Predicate The predicate should take a const reference to a value and return a bool
+    /// @param pred The predicate to apply to each value
+    /// @return The extended view
+    template <typename Predicate>
+    ListView<FilterStage<Source, Predicate>> Filter(Predicate pred) const
+    {
+        return ListView<FilterStage<Source, Predicate>>(FilterStage<Source, Predicate>(_source, pred));
+    }
+
+    /// @brief Adds a stage that replaces every value with the result of a function.
+    /// @tparam Function The function should take a const reference to a value and return the new value
+    /// @param func The function to apply to each value
+    /// @return The extended view
+    template <typename Function>
+    ListView<MapStage<Source, Function>> Map(Function func) const
+    {
+        return ListView<MapStage<Source, Function>>(MapStage<Source, Function>(_source, func));
+    }
+
+    /// @brief Adds a stage that keeps the first count values and ends the walk after them.
+    /// @param count The number of values to keep
+    /// @return The extended view
+    ListView<TakeStage<Source>> Take(int count) const
+    {
+        return ListView<TakeStage<Source>>(TakeStage<Source>(_source, count));
+    }
+
+    /// @brief Applies a function to each value coming out of the pipeline.
+    /// @tparam Function The function should take a const reference to a value and return void.
+    /// @param func The function to apply
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        auto sink = [&func](const value_type &value)
+        {
+            func(value);
+            return true;
+        };
+        _source.Push(sink);
+    }
+
+    /// @brief Folds the values coming out of the pipeline into one result.
+    /// @tparam Result The type of the result
+    /// @tparam Operation The operation should take the result so far and a const reference to a value, and
+    /// return the new result
+    /// @param init The result for an empty pipeline
+    /// @param op The operation to fold with
+    /// @return The folded result
+    template <typename Result, typename Operation>
+    Result Reduce(Result init, Operation op) const
+    {
+        auto sink = [&init, &op](const value_type &value)
+        {
+            init = op(init, value);
+            return true;
+        };
+        _source.Push(sink);
+        return init;
+    }
+
+    /// @brief Counts the values coming out of the pipeline.
+    /// @return The number of values
+    int Count() const
+    {
+        int count = 0;
+        auto sink = [&count](const value_type &)
+        {
+            count++;
+            return true;
+        };
+        _source.Push(sink);
+        return count;
+    }
+
+    /// @brief Appends the values coming out of the pipeline to a list.
+    /// @tparam List A list with Append(value)
+    /// @param list The list to append to.  Must not be the list the view walks.
+    template <typename List>
+    void CollectInto(List &list) const
+    {
+        auto sink = [&list](const value_type &value)
+        {
+            list.Append(value);
+            return true;
+        };
+        _source.Push(sink);
+    }
+
+private:
+    Source _source; ///< The last stage of the pipeline
+};
+
+/// @brief Starts a pipeline over the elements of a list.
+/// @tparam List A list with const begin() and end()
+/// @param list The list to walk.  Must outlive the view.
+/// @return A view of every element of the list
+template <typename List>
+ListView<ListSource<List>> MakeListView(const List &list)
+{
+    return ListView<ListSource<List>>(ListSource<List>(list));
+}
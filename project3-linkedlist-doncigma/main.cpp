@@ -7,9 +7,11 @@
 #include <cmath>
 #include "include/cxxopts.hpp"
 
+#include "checktest.hpp"
 #include "helpers.hpp"
 #include "linkedlist.hpp"
 #include "linkedlisttest.hpp"
+#include "threadpool.hpp"
 
 using namespace std;
 
@@ -41,12 +43,16 @@ bool ProcessCommand(const string &command, const vector<string> &params, string
 vector<TestFunctionEntry> baseCommands = {
     {"quit", "quit", quit},
     {"help", "help [command] - gives help for the optional command.", help},
-    {"test", "test <input file> - tests a file.", test},
+    {"test", "test <input file> [input file...] [-j threads] - tests files, several at a time with -j.", test},
     {"?", "? [command] - gives help for the optional command.", help},
 };
 
 std::map<std::string, TestFunctionEntry> commandMap;
 
+/// @brief The number of test files that failed or could not be opened.  Makes the repl exit with a
+/// failure status when it runs tests non-interactively, so "make test" fails too.
+int failedTestFiles = 0;
+
 void ProcessStream(istream *sourceStream, ostream *outputStream, bool interactive)
 {
     if (sourceStream == NULL)
@@ -106,10 +112,11 @@ int main(int argc, char *argv[])
 
     cxxopts::Options options("REPL", "A simple C++ REPL");
 
-    options.add_options()("e,expression", "Evaluate the provided arithmetic expression", cxxopts::value<string>())("h,help", "Display this help message")("s,source", "Source file to evaluate line by line.", cxxopts::value<string>())("i,interactive", "Source file to evaluate line by line.")("o,allOutput", "Output file to write results to.", cxxopts::value<string>());
+    options.add_options()("e,expression", "Evaluate the provided arithmetic expression", cxxopts::value<string>())("h,help", "Display this help message")("s,source", "Source file to evaluate line by line.", cxxopts::value<string>())("i,interactive", "Source file to evaluate line by line.")("o,allOutput", "Output file to write results to.", cxxopts::value<string>())("t,threads", "Number of worker threads for the parallel commands.  Defaults to the number of hardware threads.", cxxopts::value<int>());
 
     AddCommands(baseCommands, commandMap);
     AddCommands(linkedListTestCommands, commandMap);
+    AddCommands(checkTestCommands, commandMap);
 
     try
     {
@@ -121,6 +128,18 @@ int main(int argc, char *argv[])
             return EXIT_SUCCESS;
         }
 
+        if (result.count("threads"))
+        {
+            int threads = result["threads"].as<int>();
+
+            if (threads < 1)
+            {
+                cerr << "Error: --threads must be at least 1" << endl;
+                return EXIT_FAILURE;
+            }
+            ThreadPool::SetDefaultSize(threads);
+        }
+
         // See if we have an allOutput file to write to.
         if (result.count("allOutput"))
         {
@@ -196,6 +215,11 @@ int main(int argc, char *argv[])
         outputStream = NULL;
     }
 
+    if (!interactive && failedTestFiles > 0)
+    {
+        return EXIT_FAILURE;
+    }
+
     return 0;
 }
 
@@ -205,14 +229,14 @@ bool help(const std::vector<std::string> &params, string &allOutput, bool intera
 
     if (params.size() == 0)
     {
-        cout << "Available commands: ";
+        OutputStream() << "Available commands: ";
 
         for (const auto &pair : commandMap)
         {
-            cout << pair.first << " ";
+            OutputStream() << pair.first << " ";
         }
 
-        cout << endl;
+        OutputStream() << endl;
 
         return true;
     }
@@ -226,7 +250,7 @@ bool help(const std::vector<std::string> &params, string &allOutput, bool intera
             return true;
         }
 
-        cout << match->second._name << ": " << match->second._help << endl;
+        OutputStream() << match->second._name << ": " << match->second._help << endl;
     }
     else
     {
@@ -240,7 +264,7 @@ bool quit(const std::vector<std::string> &params, string &allOutput, bool intera
 {
     if (interactive)
     {
-        cout << "Goodbye!" << endl;
+        OutputStream() << "Goodbye!" << endl;
     }
 
     allOutput = "";
@@ -248,27 +272,28 @@ bool quit(const std::vector<std::string> &params, string &allOutput, bool intera
     return false;
 }
 
-bool test(const std::vector<std::string> &params, string &allOutput, bool interactive, int currentLine)
+/// @brief Runs the commands of a test file in a session of its own and compares their results with the expected ones.
+/// @param filename The test file to run.
+/// @param lines Set to the comparison of every line.
+/// @param echo Whether to also print each comparison to OutputStream() as soon as it is made.
+/// @param interactive Whether the test command is being run in an interactive session.
+/// @param currentLine The line of the test command, for errors about the file itself.
+/// @return The number of lines whose result differed from the expected one, or -1 if the file could not be opened.
+int RunTestFile(const string &filename, string &lines, bool echo, bool interactive, int currentLine)
 {
     ifstream testInputFile;
 
-    if (params.size() != 1)
-    {
-        throw std::invalid_argument("test requires one parameter");
-    }
-
-    testInputFile.open(params[0]);
+    testInputFile.open(filename);
 
     if (testInputFile.fail())
     {
-        PrintError(currentLine, 0, "Could not open input file '" + params[0] + "'");
-        allOutput = "";
-        return true;
+        PrintError(currentLine, 0, "Could not open input file '" + filename + "'");
+        return -1;
     }
 
+    TestSession session;
     int fileCurrentLine = 0;
     int errorCount = 0;
-    allOutput = "";
 
     while (true)
     {
@@ -293,14 +318,21 @@ bool test(const std::vector<std::string> &params, string &allOutput, bool intera
         string outputTrim = trim(output);
         string expectedOutputTrim = trim(expectedOutput);
 
-        string matchString = (outputTrim != expectedOutputTrim) ? "differs" : "same";
+        bool differs = outputTrim != expectedOutputTrim;
+        string matchString = differs ? "differs" : "same";
         {
             stringstream sstr;
             sstr << "Line " << fileCurrentLine << " " << matchString << ": Command: \'" << command << "\'; Result: \'" << outputTrim << "\'; Expected: \'" << expectedOutputTrim << "\'" << endl;
-            allOutput += sstr.str();
-            cout << sstr.str();
+            lines += sstr.str();
+            if (echo)
+            {
+                OutputStream() << sstr.str();
+            }
 
-            errorCount++;
+            if (differs)
+            {
+                errorCount++;
+            }
         }
 
         if (!b)
@@ -309,13 +341,132 @@ bool test(const std::vector<std::string> &params, string &allOutput, bool intera
         }
     }
 
+    return errorCount;
+}
+
+/// @brief Builds the summary line printed after the comparisons of a test file.
+string TestSummary(int errorCount)
+{
     if (errorCount == 0)
     {
-        allOutput += "\nAll tests passed\n";
+        return "\nAll tests passed\n";
+    }
+    return "\nFailed test count - " + to_string(errorCount) + "\n";
+}
+
+bool test(const std::vector<std::string> &params, string &allOutput, bool interactive, int currentLine)
+{
+    vector<string> filenames;
+    int jobs = 1;
+
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        if (params[i] == "-j")
+        {
+            if (i + 1 == params.size())
+            {
+                throw std::invalid_argument("-j requires a thread count");
+            }
+
+            jobs = stoi(params[++i]);
+            if (jobs < 1)
+            {
+                throw std::invalid_argument("-j requires at least 1 thread");
+            }
+        }
+        else
+        {
+            filenames.push_back(params[i]);
+        }
+    }
+
+    if (filenames.empty())
+    {
+        throw std::invalid_argument("test requires at least one input file");
+    }
+
+    int fileCount = static_cast<int>(filenames.size());
+    vector<string> lines(fileCount);
+    vector<int> errorCounts(fileCount);
+
+    if (jobs == 1 || fileCount == 1)
+    {
+        for (int i = 0; i < fileCount; i++)
+        {
+            errorCounts[i] = RunTestFile(filenames[i], lines[i], true, interactive, currentLine);
+        }
+    }
+    else
+    {
+        // Every file reports into buffers of its own, printed in the order the files were given.  The
+        // output buffer gets the comparisons and whatever commands such as help print, in the order a
+        // single thread would have printed them.
+        vector<string> errors(fileCount);
+        vector<string> outputs(fileCount);
+        ThreadPool pool(jobs < fileCount ? jobs : fileCount);
+
+        pool.ParallelFor(fileCount, [&](int i)
+                         {
+                             ostringstream errorBuffer;
+                             ostringstream outputBuffer;
+                             ostream *previousError = SetErrorStream(&errorBuffer);
+                             ostream *previousOutput = SetOutputStream(&outputBuffer);
+                             errorCounts[i] = RunTestFile(filenames[i], lines[i], true, interactive, currentLine);
+                             SetOutputStream(previousOutput);
+                             SetErrorStream(previousError);
+                             errors[i] = errorBuffer.str();
+                             outputs[i] = outputBuffer.str(); });
+
+        for (int i = 0; i < fileCount; i++)
+        {
+            ErrorStream() << errors[i];
+            OutputStream() << outputs[i];
+        }
+    }
+
+    allOutput = "";
+
+    for (int errorCount : errorCounts)
+    {
+        if (errorCount != 0)
+        {
+            failedTestFiles++;
+        }
+    }
+
+    if (fileCount == 1)
+    {
+        if (errorCounts[0] >= 0)
+        {
+            allOutput = lines[0] + TestSummary(errorCounts[0]);
+        }
+        return true;
+    }
+
+    int failedFiles = 0;
+    for (int i = 0; i < fileCount; i++)
+    {
+        if (errorCounts[i] < 0)
+        {
+            allOutput += "Test file '" + filenames[i] + "' could not be opened\n";
+            failedFiles++;
+            continue;
+        }
+
+        allOutput += "Test file '" + filenames[i] + "'\n" + lines[i] + TestSummary(errorCounts[i]) + "\n";
+        if (errorCounts[i] > 0)
+        {
+            failedFiles++;
+        }
+    }
+
+    if (failedFiles == 0)
+    {
+        allOutput += "All " + to_string(fileCount) + " test files passed\n";
     }
     else
     {
-        allOutput += "\nFailed test count - " + to_string(errorCount) + "\n";
+        allOutput += "Failed test files - " + to_string(failedFiles) + " of " + to_string(fileCount) + "\n";
     }
 
     return true;
@@ -358,7 +509,8 @@ bool ProcessCommand(const string &command, const vector<string> &params, string
     {
         try
         {
-            return commandMap[matches.front()]._function(params, allOutput, interactive, currentLine);
+            // find() rather than [], since test files running on other threads use the map too.
+            return commandMap.find(matches.front())->second._function(params, allOutput, interactive, currentLine);
         }
         catch (const std::invalid_argument &e)
         {
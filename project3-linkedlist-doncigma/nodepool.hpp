@@ -0,0 +1,273 @@
+/// @file nodepool.hpp
+/// @brief A slab/free-list allocator for fixed size list nodes
+/// @details NodePool hands out single objects from large contiguous blocks instead of going to the
+/// general purpose heap for every node.  Freed objects are pushed onto a free list and handed out again
+/// by the next allocation, so a list that keeps appending and removing settles into a steady state with
+/// no heap traffic at all.
+///
+/// The pool is stateless from the point of view of its users: every NodePool<T> compares equal, and
+/// nodes allocated by one list may be freed by any other list of the same type.  Each thread keeps its
+/// own free list so allocation never takes a lock, and blocks are never returned to the heap, so a node
+/// can safely be freed from any thread or during static destruction.
+///
+/// When a thread exits, its free list is handed to a shared list guarded by a mutex, and a thread whose
+/// own free list runs dry takes a batch from the shared list before it carves up a new block.  So the
+/// nodes freed on short-lived threads, such as thread pool workers, are reused rather than lost.  Nodes
+/// freed on a thread after its free list was handed back go straight to the shared list.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// @brief Standard conforming allocator that serves single objects from a per-thread free list.
+/// @tparam T The type of object to allocate.  Usually rebound by the container to its node type.
+template <typename T>
+class NodePool
+{
+public:
+    typedef T value_type;
+
+    /// @brief Rebinds the pool to another type.  Each type gets its own free list.
+    template <typename U>
+    struct rebind
+    {
+        typedef NodePool<U> other;
+    };
+
+    /// @brief The number of objects carved out of each block requested from the heap.
+    static const std::size_t NodesPerBlock = 256;
+
+    NodePool() noexcept {}
+
+    template <typename U>
+    NodePool(const NodePool<U> &) noexcept {}
+
+    /// @brief Allocates storage for n objects.  Single objects come from the free list.
+    /// @param n The number of objects to allocate storage for.
+    /// @return Pointer to uninitialized storage.
+    T *allocate(std::size_t n)
+    {
+        if (n != 1)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        ThreadCache &cache = Cache();
+
+        if (cache.freeList == nullptr)
+        {
+            if (cache.exited)
+            {
+                return reinterpret_cast<T *>(TakeOne());
+            }
+            RegisterExit();
+            cache.freeList = TakeBatch();
+        }
+
+        Slot *slot = cache.freeList;
+        cache.freeList = slot->next;
+
+        return reinterpret_cast<T *>(slot);
+    }
+
+    /// @brief Returns storage for n objects.  Single objects go back onto this thread's free list.
+    /// @param p Pointer previously returned by allocate().
+    /// @param n The number of objects p was allocated for.
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        if (n != 1)
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        ThreadCache &cache = Cache();
+        Slot *slot = reinterpret_cast<Slot *>(p);
+
+        if (cache.exited)
+        {
+            GiveShared(slot, slot);
+            return;
+        }
+        if (cache.freeList == nullptr)
+        {
+            // The first node on an empty list, so make sure the list is handed back when the thread exits.
+            RegisterExit();
+        }
+
+        slot->next = cache.freeList;
+        cache.freeList = slot;
+    }
+
+    /// @brief The number of blocks requested from the heap so far for this type, for tests and benchmarks.
+    /// @return The number of blocks
+    static std::size_t BlockCount()
+    {
+        SharedFreeList &shared = Shared();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        return shared.blocks.size();
+    }
+
+private:
+    /// @brief A slot either holds a live object or, while free, the link to the next free slot.
+    union Slot
+    {
+        Slot *next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    /// @brief The free list of a thread.  Trivially destructible, so it can still be used while the thread
+    /// exits and after its thread_local objects with destructors are gone.
+    struct ThreadCache
+    {
+        Slot *freeList; ///< The slots this thread can hand out without a lock
+        bool exited;    ///< Set once freeList was handed back to the shared list
+    };
+
+    /// @brief The slots of threads that have exited, shared by every thread, and every block
+    struct SharedFreeList
+    {
+        std::mutex lock;            ///< Guards head and blocks
+        Slot *head;                 ///< The first shared slot, or nullptr
+        std::vector<Slot *> blocks; ///< Every block requested from the heap
+
+        SharedFreeList() : head(nullptr) {}
+    };
+
+    /// @brief Hands the free list of the calling thread back to the shared list when the thread exits.
+    struct ExitHandler
+    {
+        ~ExitHandler()
+        {
+            ThreadCache &cache = Cache();
+
+            if (cache.freeList != nullptr)
+            {
+                Slot *last = cache.freeList;
+                while (last->next != nullptr)
+                {
+                    last = last->next;
+                }
+                GiveShared(cache.freeList, last);
+            }
+            cache.freeList = nullptr;
+            cache.exited = true;
+        }
+    };
+
+    /// @brief The free list of the calling thread.
+    static ThreadCache &Cache()
+    {
+        static thread_local ThreadCache cache = {nullptr, false};
+        return cache;
+    }
+
+    /// @brief Makes sure the calling thread hands back its free list when it exits.
+    static void RegisterExit()
+    {
+        static thread_local ExitHandler handler;
+        (void)handler;
+    }
+
+    /// @brief The shared list.  Never destroyed, so threads exiting during static destruction can use it.
+    static SharedFreeList &Shared()
+    {
+        static SharedFreeList *shared = new SharedFreeList();
+        return *shared;
+    }
+
+    /// @brief Adds a chain of slots to the shared list.
+    /// @param first The first slot of the chain
+    /// @param last The last slot of the chain
+    static void GiveShared(Slot *first, Slot *last)
+    {
+        SharedFreeList &shared = Shared();
+        std::lock_guard<std::mutex> guard(shared.lock);
+
+        last->next = shared.head;
+        shared.head = first;
+    }
+
+    /// @brief Takes a single slot, for threads that already handed back their own list.  The rest of the
+    /// batch goes to the shared list.
+    /// @return The slot
+    static Slot *TakeOne()
+    {
+        Slot *slots = TakeBatch();
+        Slot *slot = slots;
+
+        if (slots->next != nullptr)
+        {
+            Slot *last = slots->next;
+            while (last->next != nullptr)
+            {
+                last = last->next;
+            }
+            GiveShared(slots->next, last);
+        }
+        return slot;
+    }
+
+    /// @brief Finds slots for a thread whose free list ran dry: up to a block's worth from the shared list,
+    /// or a new block when the shared list is empty.
+    /// @return The first slot of a new free list
+    static Slot *TakeBatch()
+    {
+        {
+            SharedFreeList &shared = Shared();
+            std::lock_guard<std::mutex> guard(shared.lock);
+
+            if (shared.head != nullptr)
+            {
+                Slot *first = shared.head;
+                Slot *last = first;
+
+                for (std::size_t i = 1; i < NodesPerBlock && last->next != nullptr; i++)
+                {
+                    last = last->next;
+                }
+                shared.head = last->next;
+                last->next = nullptr;
+                return first;
+            }
+        }
+
+        return AllocateBlock();
+    }
+
+    /// @brief Requests a new block from the heap and threads all of its slots into a free list.
+    /// @return The first slot of the new free list.
+    static Slot *AllocateBlock()
+    {
+        Slot *block = static_cast<Slot *>(::operator new(NodesPerBlock * sizeof(Slot)));
+
+        for (std::size_t i = 0; i + 1 < NodesPerBlock; i++)
+        {
+            block[i].next = &block[i + 1];
+        }
+        block[NodesPerBlock - 1].next = nullptr;
+
+        // Keep the block reachable for the lifetime of the process.  The shared list is never destroyed
+        // so lists with static storage duration can still free their nodes on exit.
+        SharedFreeList &shared = Shared();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        shared.blocks.push_back(block);
+
+        return block;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const NodePool<T> &, const NodePool<U> &) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const NodePool<T> &, const NodePool<U> &) noexcept
+{
+    return false;
+}
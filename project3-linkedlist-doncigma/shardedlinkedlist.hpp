@@ -0,0 +1,187 @@
+/// @file shardedlinkedlist.hpp
+/// @brief A list that many threads can append to without contending on a shared tail
+/// @details Every thread appends to its own shard, an ordinary LinkedList behind a mutex that nothing but
+/// that thread and the occasional reader ever takes, so appends from different threads touch no shared
+/// cache lines.  Threads are numbered in the order they first append and thread i uses shard i modulo the
+/// number of shards, so up to that many threads never share a shard.
+///
+/// Reads merge first: the chain of every shard is spliced onto the end of one merged list in O(1) per
+/// shard, and the read then walks the merged list.  Elements appended by one thread keep their order.
+/// Elements from different threads are ordered by the read that merged them, and within one merge by
+/// shard.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+
+/// @brief A linked list with per-thread shards for appends and a merged view for reads
+/// @tparam T The type of the elements stored in the list
+/// @tparam Allocator Allocator used for the nodes of every shard
+template <typename T, typename Allocator = NodePool<T>>
+class ShardedLinkedList
+{
+public:
+    /// @brief The size of a cache line on the platforms we run on
+    static const std::size_t CacheLineSize = 64;
+
+    /// @brief The most shards a list can have
+    static const int MaxShards = 64;
+
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    /// @param shards The number of shards.  Defaults to the number of hardware threads.
+    explicit ShardedLinkedList(int shards = static_cast<int>(std::thread::hardware_concurrency()))
+    {
+        _shardCount = shards < 1 ? 1 : shards > MaxShards ? MaxShards : shards;
+    }
+
+    ShardedLinkedList(const ShardedLinkedList &) = delete;
+    ShardedLinkedList &operator=(const ShardedLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the calling thread's shard
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        Shard &shard = LocalShard();
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.list.Append(value);
+    }
+
+    /// @brief Function to add a new element to the end of the calling thread's shard
+    /// @param value The value to be moved into the list
+    void Append(T &&value)
+    {
+        Shard &shard = LocalShard();
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.list.Append(std::move(value));
+    }
+
+    /// @brief Function to get the number of shards
+    /// @return The number of shards
+    int ShardCount() const
+    {
+        return _shardCount;
+    }
+
+    /// @brief Function to get the size of the linked list.  Only a snapshot when other threads are appending.
+    /// @return The size of the linked list
+    int Size() const
+    {
+        // Held while summing, in the same order as Merge, so no read can move a shard's elements into the
+        // merged list between counting the shard and counting the merged list.
+        std::lock_guard<std::mutex> mergedGuard(_mergedLock);
+        int size = _merged.Size();
+
+        for (int i = 0; i < _shardCount; i++)
+        {
+            std::lock_guard<std::mutex> guard(_shards[i].lock);
+            size += _shards[i].list.Size();
+        }
+        return size;
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+
+    /// @brief Function to clear the linked list
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        std::lock_guard<std::mutex> guard(_mergedLock);
+        Merge();
+        _merged.Clear();
+    }
+
+    /// @brief Moves every element out into one ordinary list, leaving this one empty.  O(number of shards).
+    /// @return The merged elements
+    LinkedList<T, Allocator> TakeAll()
+    {
+        std::lock_guard<std::mutex> guard(_mergedLock);
+        Merge();
+        return std::move(_merged);
+    }
+
+    /// @brief Function to find an element that satisfies a predicate in the merged list
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return A copy of the first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    T Find(Predicate pred) const
+    {
+        std::lock_guard<std::mutex> guard(_mergedLock);
+        Merge();
+        return _merged.Find(pred);
+    }
+
+    /// @brief Finds the index of the first element in the merged list that satisfies the given predicate.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        std::lock_guard<std::mutex> guard(_mergedLock);
+        Merge();
+        return _merged.FindIndex(pred);
+    }
+
+    /// @brief Applies a function to each element of the merged list.  Appends made meanwhile go to the
+    /// shards and wait for the next read.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        std::lock_guard<std::mutex> guard(_mergedLock);
+        Merge();
+        _merged.ForEach(func);
+    }
+
+private:
+    /// @brief A shard on its own cache lines
+    struct alignas(CacheLineSize) Shard
+    {
+        mutable std::mutex lock;       ///< Guards list
+        LinkedList<T, Allocator> list; ///< The elements appended by the threads using this shard
+    };
+
+    /// @brief Numbers the threads in the order they first ask.
+    static int ThreadIndex()
+    {
+        static std::atomic<int> nextIndex(0);
+        static thread_local int index = nextIndex++;
+        return index;
+    }
+
+    Shard &LocalShard()
+    {
+        return _shards[ThreadIndex() % _shardCount];
+    }
+
+    /// @brief Splices the chain of every shard onto the merged list.  Must be called with _mergedLock held.
+    void Merge() const
+    {
+        for (int i = 0; i < _shardCount; i++)
+        {
+            // Only relinks the chain, so the shard is locked for a few pointer updates.
+            std::lock_guard<std::mutex> guard(_shards[i].lock);
+            _merged.Splice(std::move(_shards[i].list));
+        }
+    }
+
+    mutable Shard _shards[MaxShards];         ///< The shards, of which the first _shardCount are used
+    int _shardCount;                          ///< The number of shards in use
+    mutable std::mutex _mergedLock;           ///< Guards _merged
+    mutable LinkedList<T, Allocator> _merged; ///< Elements merged by earlier reads
+};
@@ -0,0 +1,371 @@
+/// @file simdsearch.hpp
+/// @brief Equality search over a run of contiguous elements, with SSE2 or AVX2 compares for arithmetic types
+/// @details A vector kernel compares a whole register of elements with the value at once and turns the
+/// result into a bit mask with one bit per byte.  The first match is then the lowest set bit divided by
+/// the element size, and the number of matches is the number of set bits that start an element.
+///
+/// The instruction set is picked at compile time: AVX2 when the compiler may use it (-mavx2 or
+/// -march=native), SSE2 otherwise on x86-64.  64-bit integers need AVX2 or SSE4.1.  Every other type, and
+/// every other platform, uses the scalar loop, which compares with operator== like the vector kernels do
+/// for the arithmetic types.
+#pragma once
+
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/// @brief The vector compare for elements of a given size.  Only the specializations below are available.
+/// @tparam Size The size of an element in bytes
+/// @tparam Floating Whether the elements are floating point
+template <int Size, bool Floating>
+struct SimdLanes
+{
+    static const bool Available = false;
+};
+
+#if defined(__AVX2__)
+
+/// @brief The name of the instruction set the vector kernels use
+inline const char *SimdInstructionSet()
+{
+    return "AVX2";
+}
+
+template <>
+struct SimdLanes<1, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256i Vector;
+
+    static Vector Splat(long long value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(static_cast<const __m256i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<2, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256i Vector;
+
+    static Vector Splat(long long value) { return _mm256_set1_epi16(static_cast<short>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256(static_cast<const __m256i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<4, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256i Vector;
+
+    static Vector Splat(long long value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256(static_cast<const __m256i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<8, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256i Vector;
+
+    static Vector Splat(long long value) { return _mm256_set1_epi64x(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_loadu_si256(static_cast<const __m256i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<4, true>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256 Vector;
+
+    static Vector Splat(float value) { return _mm256_set1_ps(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        __m256 equal = _mm256_cmp_ps(_mm256_loadu_ps(static_cast<const float *>(items)), needle, _CMP_EQ_OQ);
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(equal)));
+    }
+};
+
+template <>
+struct SimdLanes<8, true>
+{
+    static const bool Available = true;
+    static const int Bytes = 32;
+    typedef __m256d Vector;
+
+    static Vector Splat(double value) { return _mm256_set1_pd(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        __m256d equal = _mm256_cmp_pd(_mm256_loadu_pd(static_cast<const double *>(items)), needle, _CMP_EQ_OQ);
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(equal)));
+    }
+};
+
+#elif defined(__SSE2__)
+
+/// @brief The name of the instruction set the vector kernels use
+inline const char *SimdInstructionSet()
+{
+    return "SSE2";
+}
+
+template <>
+struct SimdLanes<1, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128i Vector;
+
+    static Vector Splat(long long value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(static_cast<const __m128i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<2, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128i Vector;
+
+    static Vector Splat(long long value) { return _mm_set1_epi16(static_cast<short>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(static_cast<const __m128i *>(items)), needle)));
+    }
+};
+
+template <>
+struct SimdLanes<4, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128i Vector;
+
+    static Vector Splat(long long value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(static_cast<const __m128i *>(items)), needle)));
+    }
+};
+
+#if defined(__SSE4_1__)
+template <>
+struct SimdLanes<8, false>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128i Vector;
+
+    static Vector Splat(long long value) { return _mm_set1_epi64x(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi64(_mm_loadu_si128(static_cast<const __m128i *>(items)), needle)));
+    }
+};
+#endif
+
+template <>
+struct SimdLanes<4, true>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128 Vector;
+
+    static Vector Splat(float value) { return _mm_set1_ps(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        __m128 equal = _mm_cmpeq_ps(_mm_loadu_ps(static_cast<const float *>(items)), needle);
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(equal)));
+    }
+};
+
+template <>
+struct SimdLanes<8, true>
+{
+    static const bool Available = true;
+    static const int Bytes = 16;
+    typedef __m128d Vector;
+
+    static Vector Splat(double value) { return _mm_set1_pd(value); }
+    static unsigned Mask(const void *items, Vector needle)
+    {
+        __m128d equal = _mm_cmpeq_pd(_mm_loadu_pd(static_cast<const double *>(items)), needle);
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(equal)));
+    }
+};
+
+#else
+
+/// @brief The name of the instruction set the vector kernels use
+inline const char *SimdInstructionSet()
+{
+    return "scalar";
+}
+
+#endif
+
+/// @brief Equality search over a run of elements.  This is the scalar loop, used for every type without a
+/// vector compare.
+/// @tparam T The element type.  Must have operator==.
+template <typename T, typename Enable = void>
+struct SimdSearch
+{
+    /// @brief Whether the search uses vector compares for T
+    static const bool Vectorized = false;
+
+    /// @brief Finds the first element equal to value.
+    /// @param items The first element of the run
+    /// @param count The number of elements in the run
+    /// @param value The value to look for
+    /// @return The index of the first match, or -1 if there is none
+    static int FindFirst(const T *items, int count, const T &value)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (items[i] == value)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /// @brief Counts the elements equal to value.
+    /// @param items The first element of the run
+    /// @param count The number of elements in the run
+    /// @param value The value to count
+    /// @return The number of matches
+    static int Count(const T *items, int count, const T &value)
+    {
+        int matches = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            matches += items[i] == value;
+        }
+        return matches;
+    }
+};
+
+/// @brief Whether T is an arithmetic type with a vector compare.  bool is left out, since only the values
+/// 0 and 1 are guaranteed to compare like bytes.
+template <typename T>
+struct HasSimdLanes
+{
+    static const bool value = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                              SimdLanes<sizeof(T), std::is_floating_point<T>::value>::Available;
+};
+
+/// @brief Equality search over a run of elements with vector compares
+/// @tparam T An arithmetic element type
+template <typename T>
+struct SimdSearch<T, typename std::enable_if<HasSimdLanes<T>::value>::type>
+{
+    typedef SimdLanes<sizeof(T), std::is_floating_point<T>::value> Lanes;
+
+    /// @brief Whether the search uses vector compares for T
+    static const bool Vectorized = true;
+
+    /// @brief Finds the first element equal to value.
+    /// @param items The first element of the run
+    /// @param count The number of elements in the run
+    /// @param value The value to look for
+    /// @return The index of the first match, or -1 if there is none
+    static int FindFirst(const T *items, int count, const T &value)
+    {
+        const int lanes = Lanes::Bytes / static_cast<int>(sizeof(T));
+        typename Lanes::Vector needle = Lanes::Splat(value);
+        int i = 0;
+
+        for (; i + lanes <= count; i += lanes)
+        {
+            unsigned mask = Lanes::Mask(items + i, needle);
+            if (mask != 0)
+            {
+                return i + __builtin_ctz(mask) / static_cast<int>(sizeof(T));
+            }
+        }
+
+        for (; i < count; i++)
+        {
+            if (items[i] == value)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /// @brief Counts the elements equal to value.
+    /// @param items The first element of the run
+    /// @param count The number of elements in the run
+    /// @param value The value to count
+    /// @return The number of matches
+    static int Count(const T *items, int count, const T &value)
+    {
+        const int lanes = Lanes::Bytes / static_cast<int>(sizeof(T));
+        typename Lanes::Vector needle = Lanes::Splat(value);
+        int matches = 0;
+        int i = 0;
+
+        for (; i + lanes <= count; i += lanes)
+        {
+            matches += CountLanes(Lanes::Mask(items + i, needle) & FirstByteOfLanes());
+        }
+
+        for (; i < count; i++)
+        {
+            matches += items[i] == value;
+        }
+        return matches;
+    }
+
+private:
+    /// @brief A mask with the bit of the first byte of every lane set
+    static unsigned FirstByteOfLanes()
+    {
+        unsigned bits = 0;
+        for (int i = 0; i < Lanes::Bytes; i += static_cast<int>(sizeof(T)))
+        {
+            bits |= 1u << i;
+        }
+        return bits;
+    }
+
+    /// @brief Counts the set bits of a mask.  Without the popcnt instruction __builtin_popcount is a library
+    /// call, so clear the lowest bit per match instead, which is cheap while matches are rare.
+    static int CountLanes(unsigned mask)
+    {
+#if defined(__POPCNT__)
+        return __builtin_popcount(mask);
+#else
+        int bits = 0;
+        for (; mask != 0; mask &= mask - 1)
+        {
+            bits++;
+        }
+        return bits;
+#endif
+    }
+};
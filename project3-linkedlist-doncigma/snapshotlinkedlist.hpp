@@ -0,0 +1,577 @@
+/// @file snapshotlinkedlist.hpp
+/// @brief A linked list where readers walk a consistent snapshot without locks while one writer edits it
+/// @details Every change the writer makes gets the next version number.  A node records the version that
+/// inserted it and, once removed, the version that removed it.  A reader takes the current version as its
+/// snapshot and only sees nodes inserted at or before it and not yet removed at it, so however long a
+/// walk takes it sees the list exactly as it was when the snapshot was taken.
+///
+/// Removal is therefore only logical at first: the node stays linked so older snapshots can still see
+/// it.  Readers announce their snapshot in a slot, and once no slot holds a version older than the
+/// removal the writer unlinks the node.  A reader may still be standing on it at that point, so it is
+/// freed only after every reader that started before the unlink has finished; the unlink gets a version
+/// of its own to tell those readers apart.
+///
+/// Both steps happen while the writer is doing other work anyway, so nothing is ever freed by a reader
+/// and a reader never waits for the writer.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+
+/// @brief A linked list with one writer and any number of lock-free snapshot readers
+/// @tparam T The type of the elements stored in the list
+/// @tparam Allocator Allocator used for the nodes.  It is rebound to the node type.  Only the writer
+/// thread allocates and frees nodes.
+template <typename T, typename Allocator = NodePool<T>>
+class SnapshotLinkedList
+{
+    class Link;
+    class Node;
+
+public:
+    /// @brief The size of a cache line on the platforms we run on
+    static const std::size_t CacheLineSize = 64;
+
+    /// @brief The most readers that can hold a snapshot at the same time.  Further readers wait for a slot.
+    static const int MaxReaders = 64;
+
+    /// @brief A consistent view of the list as of one version.  Holding it keeps every node it can see
+    /// alive, so references it returns stay valid until it is destroyed.  Owned by one thread.
+    class Snapshot
+    {
+    public:
+        /// @brief Constructor - takes a snapshot of the current version of a list.
+        /// @param list The list to read
+        explicit Snapshot(const SnapshotLinkedList &list) : _list(list)
+        {
+            _slot = list.EnterReader(_version);
+        }
+
+        /// @brief Move constructor - takes over another snapshot, which no longer holds anything.
+        /// @param other The snapshot to take over
+        Snapshot(Snapshot &&other) : _list(other._list), _slot(other._slot), _version(other._version)
+        {
+            other._slot = -1;
+        }
+
+        /// @brief Destructor - releases the snapshot so the writer can free what only it could see.
+        ~Snapshot()
+        {
+            if (_slot >= 0)
+            {
+                _list._readers[_slot].version.store(FreeSlot, std::memory_order_release);
+            }
+        }
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        /// @brief Function to get the version this snapshot shows
+        /// @return The version number
+        uint64_t Version() const
+        {
+            return _version;
+        }
+
+        /// @brief Function to get the size of the list in this snapshot.  Walks the list.
+        /// @return The number of elements visible in this snapshot
+        int Size() const
+        {
+            int size = 0;
+            ForEach([&size](const T &)
+                    { size++; });
+            return size;
+        }
+
+        /// @brief Function to check if the list is empty in this snapshot
+        /// @return True if no element is visible in this snapshot, false otherwise
+        bool Empty() const
+        {
+            return Next(&_list._sentinel) == nullptr;
+        }
+
+        /// @brief Function to get the element at a specific position in this snapshot
+        /// @param position The position of the element to get
+        /// @return The element at the specified position
+        /// @throws LinkedListException if the position is invalid
+        const T &Get(int position) const
+        {
+            if (position < 0)
+            {
+                throw LinkedListException("Invalid index, Get()");
+            }
+
+            Node *ptr = Next(&_list._sentinel);
+            for (int i = 0; i < position && ptr; i++)
+            {
+                ptr = Next(ptr);
+            }
+
+            if (ptr == nullptr)
+            {
+                throw LinkedListException("Invalid index, Get()");
+            }
+            return ptr->data;
+        }
+
+        /// @brief Function to find an element that satisfies a predicate
+        /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+        /// @param pred The predicate to apply to each element in the snapshot.
+        /// @return The first element that satisfies the predicate
+        /// @throws LinkedListException if no element satisfies the predicate
+        template <typename Predicate>
+        const T &Find(Predicate pred) const
+        {
+            for (Node *ptr = Next(&_list._sentinel); ptr; ptr = Next(ptr))
+            {
+                if (pred(static_cast<const T &>(ptr->data)))
+                {
+                    return ptr->data;
+                }
+            }
+            throw LinkedListException("Invalid index, Find()");
+        }
+
+        /// @brief Finds the index of the first element in the snapshot that satisfies the given predicate.
+        /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+        /// @param pred The predicate to apply to each element in the snapshot.
+        /// @return The index of the first element in the snapshot that satisfies the predicate.
+        /// @throws LinkedListException if no element in the snapshot satisfies the predicate.
+        template <typename Predicate>
+        int FindIndex(Predicate pred) const
+        {
+            int position = 0;
+
+            for (Node *ptr = Next(&_list._sentinel); ptr; ptr = Next(ptr))
+            {
+                if (pred(static_cast<const T &>(ptr->data)))
+                {
+                    return position;
+                }
+                position++;
+            }
+            throw LinkedListException("Invalid index, FindIndex()");
+        }
+
+        /// @brief Applies a function to each element of the snapshot, in order.
+        /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+        /// @param func The function to apply.
+        template <typename Function>
+        void ForEach(Function func) const
+        {
+            for (Node *ptr = Next(&_list._sentinel); ptr; ptr = Next(ptr))
+            {
+                func(static_cast<const T &>(ptr->data));
+            }
+        }
+
+    private:
+        /// @brief Finds the next node after node that this snapshot can see.
+        Node *Next(const Link *node) const
+        {
+            Node *ptr = node->next.load(std::memory_order_acquire);
+
+            while (ptr && !ptr->VisibleAt(_version))
+            {
+                ptr = ptr->next.load(std::memory_order_acquire);
+            }
+            return ptr;
+        }
+
+        const SnapshotLinkedList &_list; ///< The list this is a snapshot of
+        int _slot;                       ///< The reader slot announcing this snapshot
+        uint64_t _version;               ///< The version this snapshot shows
+    };
+
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    SnapshotLinkedList() : _tail(&_sentinel), _liveHead(nullptr), _liveTail(nullptr), _size(0), _version(1), _slotsUsed(0)
+    {
+        for (int i = 0; i < MaxReaders; i++)
+        {
+            _readers[i].version.store(FreeSlot);
+        }
+    }
+
+    /// @brief Destructor - frees every node.  No snapshot may still be held.
+    ~SnapshotLinkedList()
+    {
+        Node *ptr = _sentinel.next.load();
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next.load();
+            DestroyNode(nodeToDel);
+        }
+
+        for (const Retired &retired : _retired)
+        {
+            DestroyNode(retired.node);
+        }
+    }
+
+    SnapshotLinkedList(const SnapshotLinkedList &) = delete;
+    SnapshotLinkedList &operator=(const SnapshotLinkedList &) = delete;
+
+    /// @brief Takes a snapshot of the current version of the list.  Safe to call from any thread.
+    /// @return The snapshot, which must be destroyed on the thread that took it
+    Snapshot Read() const
+    {
+        return Snapshot(*this);
+    }
+
+    /// @brief Function to add a new element to the end of the list.  Only the writer thread may call this.
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        uint64_t version = _version.load(std::memory_order_relaxed) + 1;
+        Node *newNode = CreateNode(value, version);
+
+        // Linked before the version is published, so readers on older snapshots skip it.
+        newNode->prev = _tail;
+        _tail->next.store(newNode, std::memory_order_release);
+        _tail = newNode;
+
+        if (_liveTail != nullptr)
+        {
+            _liveTail->nextLive = newNode;
+        }
+        else
+        {
+            _liveHead = newNode;
+        }
+        _liveTail = newNode;
+        _size++;
+
+        Publish(version);
+        Reclaim();
+    }
+
+    /// @brief Function to remove an element at a specific position.  Only the writer thread may call this.
+    /// The node disappears from new snapshots at once and is freed once no snapshot can see it.
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid
+    void RemoveAt(int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Node *before = nullptr;
+        Node *node = _liveHead;
+        for (int i = 0; i < position; i++)
+        {
+            before = node;
+            node = node->nextLive;
+        }
+
+        if (before != nullptr)
+        {
+            before->nextLive = node->nextLive;
+        }
+        else
+        {
+            _liveHead = node->nextLive;
+        }
+        if (node == _liveTail)
+        {
+            _liveTail = before;
+        }
+
+        uint64_t version = _version.load(std::memory_order_relaxed) + 1;
+        node->removed.store(version, std::memory_order_relaxed);
+        _removed.push_back(node);
+        _size--;
+
+        Publish(version);
+        Reclaim();
+    }
+
+    /// @brief Function to clear the linked list.  Only the writer thread may call this.  Existing snapshots
+    /// keep seeing the elements until they are released.
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("List already empty, Clear()");
+        }
+
+        uint64_t version = _version.load(std::memory_order_relaxed) + 1;
+
+        for (Node *node = _liveHead; node; node = node->nextLive)
+        {
+            node->removed.store(version, std::memory_order_relaxed);
+            _removed.push_back(node);
+        }
+        _liveHead = nullptr;
+        _liveTail = nullptr;
+        _size = 0;
+
+        Publish(version);
+        Reclaim();
+    }
+
+    /// @brief Function to get the size of the linked list as the writer sees it.  Only the writer thread may call this.
+    /// @return The size of the linked list
+    int Size() const
+    {
+        return _size;
+    }
+
+    /// @brief Function to check if the linked list is empty.  Only the writer thread may call this.
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    /// @brief Function to find an element that satisfies a predicate, in a snapshot taken for the call.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return A copy of the first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    T Find(Predicate pred) const
+    {
+        return Read().Find(pred);
+    }
+
+    /// @brief Finds the index of the first element that satisfies the given predicate, in a snapshot taken for the call.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        return Read().FindIndex(pred);
+    }
+
+    /// @brief Applies a function to each element of a snapshot taken for the call.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        Read().ForEach(func);
+    }
+
+private:
+    /// @brief Marks a reader slot nobody is using.  Higher than any version, so it never holds anything back.
+    static const uint64_t FreeSlot = UINT64_MAX;
+
+    /// @brief Marks a reader slot that has been claimed but has no snapshot yet.
+    static const uint64_t ClaimedSlot = UINT64_MAX - 1;
+
+    /// @brief The link to the next node.  The sentinel is just a Link, so T does not need a default constructor.
+    class Link
+    {
+    public:
+        std::atomic<Node *> next; ///< Pointer to the next node, including removed ones not yet unlinked
+
+        Link() : next(nullptr) {}
+    };
+
+    /// @brief Node class
+    class Node : public Link
+    {
+    public:
+        T data;                        ///< The data stored in the node
+        Link *prev;                    ///< Pointer to the previous node or the sentinel.  Only used by the writer.
+        Node *nextLive;                ///< Pointer to the next node that is not removed.  Only used by the writer.
+        uint64_t inserted;             ///< The version that inserted the node
+        std::atomic<uint64_t> removed; ///< The version that removed the node, or 0 while it is in the list
+
+        Node(const T &value, uint64_t version) : data(value), prev(nullptr), nextLive(nullptr), inserted(version), removed(0) {}
+
+        /// @brief Checks if a snapshot of a version can see the node.
+        bool VisibleAt(uint64_t version) const
+        {
+            uint64_t removedAt = removed.load(std::memory_order_relaxed);
+            return inserted <= version && (removedAt == 0 || removedAt > version);
+        }
+    };
+
+    /// @brief A reader slot on its own cache line
+    struct alignas(CacheLineSize) ReaderSlot
+    {
+        std::atomic<uint64_t> version; ///< The version of the snapshot using the slot, or FreeSlot
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+
+    /// @brief An unlinked node waiting for the readers that may still be on it
+    struct Retired
+    {
+        Node *node;       ///< The unlinked node
+        uint64_t version; ///< The version published right after the node was unlinked
+    };
+
+    /// @brief Claims a reader slot and announces the current version in it.
+    /// @param version Set to the version of the snapshot
+    /// @return The index of the slot
+    int EnterReader(uint64_t &version) const
+    {
+        int slot = 0;
+
+        while (true)
+        {
+            uint64_t expected = FreeSlot;
+            if (_readers[slot].version.compare_exchange_strong(expected, ClaimedSlot))
+            {
+                break;
+            }
+            if (++slot == MaxReaders)
+            {
+                slot = 0;
+                std::this_thread::yield();
+            }
+        }
+
+        // The writer only scans the slots below the high-water mark, so raise it before announcing.
+        int used = _slotsUsed.load();
+        while (used <= slot && !_slotsUsed.compare_exchange_weak(used, slot + 1))
+        {
+        }
+
+        // Announce the version, then check it is still current.  Either the writer sees the
+        // announcement when it scans the slots, or we see its newer version and announce that instead.
+        version = _version.load();
+        while (true)
+        {
+            _readers[slot].version.store(version);
+
+            uint64_t current = _version.load();
+            if (current == version)
+            {
+                return slot;
+            }
+            version = current;
+        }
+    }
+
+    /// @brief Makes a new version visible to snapshots taken from now on.
+    void Publish(uint64_t version)
+    {
+        _version.store(version);
+    }
+
+    /// @brief The oldest version any reader may be looking at, or the current version if there are no readers.
+    uint64_t OldestReader() const
+    {
+        uint64_t oldest = _version.load();
+        int used = _slotsUsed.load();
+
+        for (int i = 0; i < used; i++)
+        {
+            uint64_t version = _readers[i].version.load();
+            if (version < oldest)
+            {
+                oldest = version;
+            }
+        }
+        return oldest;
+    }
+
+    /// @brief Unlinks removed nodes no snapshot can see any more and frees unlinked nodes no reader can
+    /// still be standing on.
+    void Reclaim()
+    {
+        if (_removed.empty() && _retired.empty())
+        {
+            return;
+        }
+
+        uint64_t oldest = OldestReader();
+
+        // Retired nodes were unlinked before their version was published, so readers whose snapshot is at
+        // least that version started after the unlink and never reached them.  Both queues are in version
+        // order, so only their fronts need checking.
+        while (!_retired.empty() && _retired.front().version <= oldest)
+        {
+            DestroyNode(_retired.front().node);
+            _retired.pop_front();
+        }
+
+        // Removed nodes are invisible to every snapshot at least as new as their removal.
+        uint64_t version = _version.load(std::memory_order_relaxed) + 1;
+        std::size_t firstUnlinked = _retired.size();
+
+        while (!_removed.empty() && _removed.front()->removed.load(std::memory_order_relaxed) <= oldest)
+        {
+            Unlink(_removed.front());
+            _retired.push_back(Retired{_removed.front(), version});
+            _removed.pop_front();
+        }
+
+        if (_retired.size() > firstUnlinked)
+        {
+            Publish(version);
+        }
+    }
+
+    Node *CreateNode(const T &value, uint64_t version)
+    {
+        Node *node = NodeAllocatorTraits::allocate(_allocator, 1);
+
+        try
+        {
+            NodeAllocatorTraits::construct(_allocator, node, value, version);
+        }
+        catch (...)
+        {
+            NodeAllocatorTraits::deallocate(_allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void DestroyNode(Node *node)
+    {
+        NodeAllocatorTraits::destroy(_allocator, node);
+        NodeAllocatorTraits::deallocate(_allocator, node, 1);
+    }
+
+    /// @brief Takes a removed node out of the chain.  Readers already on it can still walk on from it.
+    void Unlink(Node *node)
+    {
+        Node *next = node->next.load(std::memory_order_relaxed);
+
+        node->prev->next.store(next, std::memory_order_release);
+        if (next != nullptr)
+        {
+            next->prev = node->prev;
+        }
+        else
+        {
+            _tail = node->prev;
+        }
+    }
+
+    Link _sentinel;                          ///< The link in front of the first element
+    Link *_tail;                             ///< The last node in the chain, or the sentinel.  Writer only.
+    Node *_liveHead;                         ///< The first node that is not removed.  Writer only.
+    Node *_liveTail;                         ///< The last node that is not removed.  Writer only.
+    int _size;                               ///< The number of elements the writer sees
+    std::deque<Node *> _removed;             ///< Removed nodes that are still linked, oldest removal first
+    std::deque<Retired> _retired;            ///< Unlinked nodes that are not freed yet, oldest unlink first
+    std::atomic<uint64_t> _version;          ///< The latest published version
+    mutable std::atomic<int> _slotsUsed;     ///< Every slot ever claimed is below this mark
+    mutable ReaderSlot _readers[MaxReaders]; ///< The snapshots in use
+
+    NodeAllocator _allocator; ///< Allocator used for every node in the list
+};
@@ -0,0 +1,187 @@
+/// @file spsclinkedlist.hpp
+/// @brief A wait-free linked list for exactly one appending thread and one popping thread
+/// @details Like ConcurrentLinkedQueue the list starts with a dummy node: the producer only touches the
+/// tail and the consumer only touches the head, but because each end has a single owner no
+/// compare-and-swap is needed.  Append publishes a node with one release store and PopFront takes it with
+/// one acquire load, so both finish in a bounded number of steps.
+///
+/// Popped nodes are not freed.  The nodes in front of the consumer's head stay linked, and the producer
+/// takes them back from the front of that chain when it needs a new node, so a list in a steady state
+/// allocates nothing.  The producer only rereads the consumer's head when its own copy says the chain of
+/// free nodes is used up.
+///
+/// The consumer's and the producer's fields live on separate cache lines so the two threads do not keep
+/// stealing one line from each other.  The alignment also rounds the size of the list up to whole lines,
+/// so whatever follows it in memory does not share the producer's line either.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// @brief A linked list with wait-free Append at the tail for one thread and PopFront at the head for another
+/// @tparam T The type of the elements stored in the list.  Must be copy or move constructible.
+template <typename T>
+class SpscLinkedList
+{
+public:
+    /// @brief The size of a cache line on the platforms we run on
+    static const std::size_t CacheLineSize = 64;
+
+    /// @brief Constructor - sets up the dummy node of an empty list.
+    SpscLinkedList()
+    {
+        Node *dummy = new Node();
+        _head.store(dummy);
+        _tail = dummy;
+        _first = dummy;
+        _headCopy = dummy;
+    }
+
+    /// @brief Destructor - frees all nodes, including the recycled ones.  Neither thread may be using the list.
+    ~SpscLinkedList()
+    {
+        Node *head = _head.load();
+
+        for (Node *ptr = head->next.load(); ptr; ptr = ptr->next.load())
+        {
+            ptr->Data().~T();
+        }
+
+        Node *ptr = _first;
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next.load();
+            delete nodeToDel;
+        }
+    }
+
+    SpscLinkedList(const SpscLinkedList &) = delete;
+    SpscLinkedList &operator=(const SpscLinkedList &) = delete;
+
+    /// @brief Adds a new element to the end of the list.  Only the producer thread may call this.
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        Node *newNode = AcquireNode();
+
+        try
+        {
+            new (&newNode->data) T(value);
+        }
+        catch (...)
+        {
+            // Give the node back to the front of the free chain.
+            newNode->next.store(_first, std::memory_order_relaxed);
+            _first = newNode;
+            throw;
+        }
+        Publish(newNode);
+    }
+
+    /// @brief Adds a new element to the end of the list.  Only the producer thread may call this.
+    /// @param value The value to be moved into the list
+    void Append(T &&value)
+    {
+        Node *newNode = AcquireNode();
+
+        try
+        {
+            new (&newNode->data) T(std::move(value));
+        }
+        catch (...)
+        {
+            newNode->next.store(_first, std::memory_order_relaxed);
+            _first = newNode;
+            throw;
+        }
+        Publish(newNode);
+    }
+
+    /// @brief Removes the first element of the list.  Only the consumer thread may call this.
+    /// @param value Set to the removed element when the list was not empty
+    /// @return True if an element was removed, false if the list was empty
+    bool PopFront(T &value)
+    {
+        Node *head = _head.load(std::memory_order_relaxed);
+        Node *next = head->next.load(std::memory_order_acquire);
+
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // next becomes the new dummy node, so its value is no longer needed once it is moved out.
+        value = std::move(next->Data());
+        next->Data().~T();
+
+        // Hands head to the producer for reuse.
+        _head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Function to check if the list is empty.  Exact on the consumer thread, a snapshot elsewhere.
+    /// @return True if the list is empty, false otherwise
+    bool Empty() const
+    {
+        return _head.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    /// @brief Node class.  A value and a pointer to the next node, like LinkedList nodes.
+    class Node
+    {
+    public:
+        std::atomic<Node *> next; ///< Pointer to the next node
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data; ///< The value, only alive between Append and PopFront
+
+        Node() : next(nullptr) {}
+
+        T &Data()
+        {
+            return *reinterpret_cast<T *>(&data);
+        }
+    };
+
+    /// @brief Takes a free node from the recycled chain, or allocates one if the consumer has not freed any.
+    /// @return A node with no value and no next node
+    Node *AcquireNode()
+    {
+        if (_first == _headCopy)
+        {
+            _headCopy = _head.load(std::memory_order_acquire);
+        }
+
+        Node *node;
+        if (_first != _headCopy)
+        {
+            node = _first;
+            _first = _first->next.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            node = new Node();
+        }
+
+        node->next.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+
+    /// @brief Links a node holding a value after the tail, making it visible to the consumer.
+    void Publish(Node *newNode)
+    {
+        _tail->next.store(newNode, std::memory_order_release);
+        _tail = newNode;
+    }
+
+    // Consumer side.
+    alignas(CacheLineSize) std::atomic<Node *> _head; ///< The dummy node in front of the first element
+
+    // Producer side.
+    alignas(CacheLineSize) Node *_tail; ///< The last node
+    Node *_first;                       ///< The oldest node; nodes from here up to _headCopy are free
+    Node *_headCopy;                    ///< The producer's last look at _head
+};
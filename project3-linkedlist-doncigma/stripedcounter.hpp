@@ -0,0 +1,123 @@
+/// @file stripedcounter.hpp
+/// @brief An element counter for the concurrent lists that many threads can update without contention
+/// @details A single atomic counter puts every insert and remove of every thread on the same cache line.
+/// StripedCounter spreads the count over stripes on cache lines of their own.  Threads are numbered in
+/// the order they first update a counter and thread i updates stripe i modulo the number of stripes, so
+/// up to that many threads never touch each other's stripe.
+///
+/// Reads come in two modes.  An exact read sums every stripe, so it sees every update that finished
+/// before it started, at the cost of reading one line per stripe.  An approximate read is a single load
+/// of a shared estimate.  A stripe only adds to the estimate after it has drifted PublishInterval away
+/// from what it last added, so the estimate is off by less than PublishInterval per stripe and the shared
+/// line is written once per PublishInterval updates instead of on every one.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+/// @brief How a concurrent list reads its size
+enum class SizeMode
+{
+    Exact,      ///< Sums every stripe of the counter.  Exact once concurrent updates have finished.
+    Approximate ///< A single load, off by less than StripedCounter::PublishInterval per stripe
+};
+
+/// @brief A counter split over per-thread stripes, with exact and approximate reads
+class StripedCounter
+{
+public:
+    /// @brief The size of a cache line on the platforms we run on
+    static const std::size_t CacheLineSize = 64;
+
+    /// @brief The most stripes a counter can have
+    static const int MaxStripes = 64;
+
+    /// @brief How far a stripe drifts from its part of the estimate before it updates the estimate
+    static const long PublishInterval = 64;
+
+    /// @brief Constructor - starts the count at 0.
+    /// @param stripes The number of stripes.  Defaults to the number of hardware threads.
+    explicit StripedCounter(int stripes = static_cast<int>(std::thread::hardware_concurrency())) : _estimate(0)
+    {
+        _stripeCount = stripes < 1 ? 1 : stripes > MaxStripes ? MaxStripes : stripes;
+    }
+
+    StripedCounter(const StripedCounter &) = delete;
+    StripedCounter &operator=(const StripedCounter &) = delete;
+
+    /// @brief Adds to the count.  Safe to call from any number of threads.
+    /// @param delta The amount to add, negative to subtract
+    void Add(long delta)
+    {
+        Stripe &stripe = _stripes[ThreadIndex() % _stripeCount];
+        long value = stripe.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+        long drift = value - stripe.published.load(std::memory_order_relaxed);
+
+        if (drift >= PublishInterval || drift <= -PublishInterval)
+        {
+            // The exchange hands every change to the estimate exactly once, even when threads share a stripe.
+            long published = stripe.published.exchange(value, std::memory_order_relaxed);
+            _estimate.fetch_add(value - published, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Adds one to the count.
+    void Increment()
+    {
+        Add(1);
+    }
+
+    /// @brief Subtracts one from the count.
+    void Decrement()
+    {
+        Add(-1);
+    }
+
+    /// @brief Function to read the count
+    /// @param mode Exact sums every stripe, Approximate reads the shared estimate.
+    /// @return The count
+    long Get(SizeMode mode = SizeMode::Exact) const
+    {
+        if (mode == SizeMode::Approximate)
+        {
+            return _estimate.load(std::memory_order_relaxed);
+        }
+
+        long total = 0;
+        for (int i = 0; i < _stripeCount; i++)
+        {
+            total += _stripes[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /// @brief Function to get the number of stripes
+    /// @return The number of stripes
+    int StripeCount() const
+    {
+        return _stripeCount;
+    }
+
+private:
+    /// @brief A stripe on its own cache line
+    struct alignas(CacheLineSize) Stripe
+    {
+        std::atomic<long> value;     ///< The updates made to this stripe
+        std::atomic<long> published; ///< The part of value already added to the estimate
+
+        Stripe() : value(0), published(0) {}
+    };
+
+    /// @brief Numbers the threads in the order they first ask.
+    static int ThreadIndex()
+    {
+        static std::atomic<int> nextIndex(0);
+        static thread_local int index = nextIndex++;
+        return index;
+    }
+
+    Stripe _stripes[MaxStripes];                        ///< The stripes, of which the first _stripeCount are used
+    int _stripeCount;                                   ///< The number of stripes in use
+    alignas(CacheLineSize) std::atomic<long> _estimate; ///< The sum of every stripe's published part
+};
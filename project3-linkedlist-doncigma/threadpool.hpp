@@ -0,0 +1,364 @@
+/// @file threadpool.hpp
+/// @brief A work-stealing pool of worker threads for the parallel list algorithms
+/// @details Every worker has its own deque of tasks.  A worker pushes the tasks it spawns onto the back of
+/// its own deque and takes work from the back too, so it keeps working on the most recent, cache-warm
+/// task.  A worker that runs out of work steals from the front of another worker's deque, which holds the
+/// oldest and usually largest pieces of work.  Tasks submitted from outside the pool go to a shared queue.
+///
+/// Fork/join code uses a TaskGroup: Run() spawns a task, and Wait() runs queued tasks on the waiting
+/// thread until every task of the group has finished, so waiting inside a task never starves the pool.
+/// ParallelFor splits its range in halves recursively, so idle workers steal large halves rather than
+/// single iterations.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief A pool of worker threads with per-worker deques and work stealing
+class ThreadPool
+{
+public:
+    /// @brief A set of tasks that can be waited for together
+    class TaskGroup
+    {
+    public:
+        /// @brief Constructor - creates an empty group.
+        /// @param pool The pool to run the tasks on
+        explicit TaskGroup(ThreadPool &pool) : _pool(pool), _pending(0) {}
+
+        /// @brief Destructor - waits for tasks that are still running, dropping their exceptions.
+        ~TaskGroup()
+        {
+            try
+            {
+                Wait();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /// @brief Spawns a task.  It may run on any worker, or on a thread that waits for a group.
+        /// @tparam Function A function that takes no parameters
+        /// @param func The task
+        template <typename Function>
+        void Run(Function func)
+        {
+            _pending++;
+            _pool.Push([this, func]()
+                       {
+                           try
+                           {
+                               func();
+                           }
+                           catch (...)
+                           {
+                               Fail(std::current_exception());
+                           }
+                           Done(); });
+        }
+
+        /// @brief Runs queued tasks until every task of the group has finished.  If any task threw, the first
+        /// exception is rethrown here.
+        void Wait()
+        {
+            while (_pending.load() > 0)
+            {
+                if (!_pool.RunPendingTask())
+                {
+                    // Our remaining tasks are running elsewhere.  Sleep briefly so new work they spawn
+                    // can still be picked up.
+                    std::unique_lock<std::mutex> guard(_lock);
+                    _finished.wait_for(guard, std::chrono::microseconds(100), [this]()
+                                       { return _pending.load() == 0; });
+                }
+            }
+
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_error)
+            {
+                std::exception_ptr error = _error;
+                _error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        void Done()
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (--_pending == 0)
+            {
+                _finished.notify_all();
+            }
+        }
+
+        void Fail(std::exception_ptr error)
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (!_error)
+            {
+                _error = error;
+            }
+        }
+
+        ThreadPool &_pool;                 ///< The pool the tasks run on
+        std::atomic<int> _pending;         ///< Tasks spawned and not finished yet
+        std::mutex _lock;                  ///< Guards _error, and _pending reaching 0
+        std::condition_variable _finished; ///< Signalled when _pending reaches 0
+        std::exception_ptr _error;         ///< The first exception a task threw
+    };
+
+    /// @brief Constructor - starts the worker threads.
+    /// @param threads The number of worker threads.  Defaults to the number of hardware threads.
+    explicit ThreadPool(int threads = static_cast<int>(std::thread::hardware_concurrency())) : _queued(0), _sleeping(0), _stopping(false)
+    {
+        threads = threads < 1 ? 1 : threads;
+
+        for (int i = 0; i < threads; i++)
+        {
+            _queues.emplace_back(new WorkerQueue());
+        }
+        for (int i = 0; i < threads; i++)
+        {
+            _workers.emplace_back([this, i]()
+                                  { WorkerLoop(i); });
+        }
+    }
+
+    /// @brief Destructor - finishes the queued tasks and joins the worker threads.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_sleepLock);
+            _stopping = true;
+        }
+        _wake.notify_all();
+
+        for (std::thread &worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief Function to get the number of worker threads
+    /// @return The number of worker threads
+    int Size() const
+    {
+        return static_cast<int>(_workers.size());
+    }
+
+    /// @brief Runs func(i) for every i in [0, count) on the pool and waits until all calls have returned.
+    /// If any call throws, the first exception is rethrown here once all calls are done.
+    /// @tparam Function The function should take an int and return void.  It is called from several threads at once.
+    /// @param count The number of iterations
+    /// @param func The function to run for each iteration
+    template <typename Function>
+    void ParallelFor(int count, Function func)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        TaskGroup group(*this);
+        std::function<void(int, int)> split = [&](int first, int last)
+        {
+            // Hand off the upper half and keep going with the lower one, down to a single iteration.
+            while (last - first > 1)
+            {
+                int middle = first + (last - first) / 2;
+                group.Run([&split, middle, last]()
+                          { split(middle, last); });
+                last = middle;
+            }
+            func(first);
+        };
+
+        group.Run([&split, count]()
+                  { split(0, count); });
+        group.Wait();
+    }
+
+    /// @brief Sets the number of worker threads of the default pool.  Only has an effect before the
+    /// first call to Default().
+    /// @param threads The number of worker threads, or 0 for the number of hardware threads
+    static void SetDefaultSize(int threads)
+    {
+        DefaultSize() = threads;
+    }
+
+    /// @brief The pool shared by code that is not handed a pool of its own.  Created on first use.
+    /// @return The default pool
+    static ThreadPool &Default()
+    {
+        static ThreadPool pool(DefaultSize() > 0 ? DefaultSize() : static_cast<int>(std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+private:
+    /// @brief The deque of one worker.  The owner uses the back, thieves the front.
+    struct WorkerQueue
+    {
+        std::mutex lock;                         ///< Guards tasks
+        std::deque<std::function<void()>> tasks; ///< Tasks spawned by the owner and not started yet
+    };
+
+    static int &DefaultSize()
+    {
+        static int size = 0;
+        return size;
+    }
+
+    /// @brief The pool the calling thread is a worker of, or nullptr
+    static ThreadPool *&CurrentPool()
+    {
+        static thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    /// @brief The worker index of the calling thread in CurrentPool()
+    static int &CurrentIndex()
+    {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    /// @brief Queues a task: on the calling worker's own deque, or on the shared queue from outside the pool.
+    void Push(std::function<void()> task)
+    {
+        // Counted first so a concurrent TakeTask never takes _queued below zero.
+        _queued++;
+
+        if (CurrentPool() == this)
+        {
+            WorkerQueue &queue = *_queues[CurrentIndex()];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            queue.tasks.push_back(std::move(task));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(_injectedLock);
+            _injected.push_back(std::move(task));
+        }
+
+        // A worker going to sleep counts itself in _sleeping before it checks _queued, so either it sees
+        // this task or we see it and wake it.
+        if (_sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> guard(_sleepLock);
+            _wake.notify_one();
+        }
+    }
+
+    /// @brief Takes a task: from the back of the own deque, then the shared queue, then the front of
+    /// another worker's deque.
+    /// @param task Set to the task that was found
+    /// @return True if a task was found
+    bool TakeTask(std::function<void()> &task)
+    {
+        int self = CurrentPool() == this ? CurrentIndex() : -1;
+
+        if (self >= 0)
+        {
+            WorkerQueue &queue = *_queues[self];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                _queued--;
+                return true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(_injectedLock);
+            if (!_injected.empty())
+            {
+                task = std::move(_injected.front());
+                _injected.pop_front();
+                _queued--;
+                return true;
+            }
+        }
+
+        int count = static_cast<int>(_queues.size());
+        for (int i = 1; i <= count; i++)
+        {
+            WorkerQueue &victim = *_queues[(self + i + count) % count];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                _queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Runs one queued task on the calling thread, if there is one.
+    /// @return True if a task was run
+    bool RunPendingTask()
+    {
+        std::function<void()> task;
+
+        if (!TakeTask(task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    void WorkerLoop(int index)
+    {
+        CurrentPool() = this;
+        CurrentIndex() = index;
+
+        while (true)
+        {
+            if (RunPendingTask())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(_sleepLock);
+            _sleeping++;
+            _wake.wait(guard, [this]()
+                       { return _stopping || _queued.load() > 0; });
+            _sleeping--;
+
+            if (_stopping && _queued.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::thread> _workers;                 ///< The worker threads
+    std::vector<std::unique_ptr<WorkerQueue>> _queues; ///< The deque of each worker
+    std::mutex _injectedLock;                          ///< Guards _injected
+    std::deque<std::function<void()>> _injected;       ///< Tasks submitted from outside the pool
+    std::atomic<int> _queued;                          ///< Tasks waiting in any deque or the shared queue
+    std::atomic<int> _sleeping;                        ///< Workers waiting for work
+    std::mutex _sleepLock;                             ///< Guards _stopping, and sleeping and waking up
+    std::condition_variable _wake;                     ///< Signalled when tasks are queued or the pool stops
+    bool _stopping;                                    ///< Set when the pool is being destroyed
+};
@@ -0,0 +1,522 @@
+/// @file unrolledlinkedlist.hpp
+/// @brief An unrolled linked list implementation
+/// @details An unrolled linked list stores a small array of elements in every node instead of a single
+/// element.  Scans touch one node per N elements, so ForEach, Find and Get run at close to array speed,
+/// while inserting or removing in the middle still only shifts the elements of a single node.
+/// A full node is split in half on insert and a node that drops below half full is merged with its
+/// successor on remove when both fit in one node.
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "linkedlist.hpp"
+#include "nodepool.hpp"
+#include "simdsearch.hpp"
+
+/// @brief A singly linked list that stores up to N elements per node
+/// @tparam T The type of the elements stored in the list
+/// @tparam N The maximum number of elements stored in each node
+/// @tparam Allocator Allocator used for the nodes.  It is rebound to the node type.
+template <typename T, int N = 16, typename Allocator = NodePool<T>>
+class UnrolledLinkedList
+{
+    static_assert(N >= 2, "UnrolledLinkedList needs room for at least two elements per node");
+
+public:
+    /// @brief Constructor - sets the initial state to be empty and self-consistent.
+    UnrolledLinkedList()
+    {
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+    }
+
+    /// @brief Destructor - cleans up all memory allocated by this class
+    ~UnrolledLinkedList()
+    {
+        if (_size > 0)
+        {
+            Clear();
+        }
+    }
+
+    UnrolledLinkedList(const UnrolledLinkedList &) = delete;
+    UnrolledLinkedList &operator=(const UnrolledLinkedList &) = delete;
+
+    /// @brief Function to add a new element to the end of the list
+    /// @param value The value to be added
+    void Append(const T &value)
+    {
+        if (_tail == nullptr || _tail->count == N)
+        {
+            LinkAfter(_tail, CreateNode(value));
+        }
+        else
+        {
+            _tail->Insert(_tail->count, value);
+        }
+        _size++;
+    }
+
+    /// @brief Function to add a new element to the beginning of the list
+    /// @param value The value to be added
+    void Prepend(const T &value)
+    {
+        if (_head == nullptr || _head->count == N)
+        {
+            LinkAfter(nullptr, CreateNode(value));
+        }
+        else
+        {
+            _head->Insert(0, value);
+        }
+        _size++;
+    }
+
+    /// @brief Function to insert a new element at a specific position
+    /// @param value The value to be inserted
+    /// @param position The position to insert the value at
+    /// @throws LinkedListException if the position is invalid
+    void InsertAt(const T &value, int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("InsertAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position > _size)
+        {
+            throw LinkedListException("Invalid index, InsertAt()");
+        }
+
+        if (position == 0)
+        {
+            Prepend(value);
+            return;
+        }
+        if (position == _size)
+        {
+            Append(value);
+            return;
+        }
+
+        int offset = position;
+        Node *node = Locate(offset);
+
+        if (node->count == N)
+        {
+            Split(node);
+
+            if (offset > node->count)
+            {
+                offset -= node->count;
+                node = node->next;
+            }
+        }
+
+        node->Insert(offset, value);
+        _size++;
+    }
+
+    /// @brief Function to remove an element at a specific position
+    /// @param position The position of the element to remove
+    /// @throws LinkedListException if the position is invalid
+    void RemoveAt(int position)
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("RemoveAt() cannot be called on an empty list");
+        }
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, RemoveAt()");
+        }
+
+        Node *prevNode = nullptr;
+        Node *node = _head;
+        int offset = position;
+
+        while (offset >= node->count)
+        {
+            offset -= node->count;
+            prevNode = node;
+            node = node->next;
+        }
+
+        node->Remove(offset);
+        _size--;
+
+        if (node->count == 0)
+        {
+            Unlink(prevNode, node);
+        }
+        else if (node->next != nullptr && node->count < N / 2 && node->count + node->next->count <= N)
+        {
+            Merge(node);
+        }
+    }
+
+    /// @brief Function to get the size of the linked list
+    /// @return The size of the linked list
+    int Size() const
+    {
+        return _size;
+    }
+
+    /// @brief Function to check if the linked list is empty
+    /// @return True if the linked list is empty, false otherwise
+    bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    /// @brief Function to clear the linked list
+    /// @throws LinkedListException if the list is already empty
+    void Clear()
+    {
+        if (_size == 0)
+        {
+            throw LinkedListException("List already empty, Clear()");
+        }
+
+        Node *ptr = _head;
+
+        while (ptr)
+        {
+            Node *nodeToDel = ptr;
+            ptr = ptr->next;
+            DestroyNode(nodeToDel);
+        }
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T Get(int position) const
+    {
+        if (position < 0 || position >= _size)
+        {
+            throw LinkedListException("Invalid index, Get()");
+        }
+
+        Node *node = Locate(position);
+        return node->At(position);
+    }
+
+    /// @brief Function to get the element at a specific position
+    /// @param position The position of the element to get
+    /// @return The element at the specified position
+    /// @throws LinkedListException if the position is invalid
+    T operator[](int position) const
+    {
+        return Get(position);
+    }
+
+    /// @brief Function to find an element that satisfies a predicate
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The first element that satisfies the predicate
+    /// @throws LinkedListException if no element satisfies the predicate
+    template <typename Predicate>
+    T Find(Predicate pred) const
+    {
+        for (Node *node = _head; node; node = node->next)
+        {
+            for (int i = 0; i < node->count; i++)
+            {
+                if (pred(node->At(i)))
+                {
+                    return node->At(i);
+                }
+            }
+        }
+        throw LinkedListException("Invalid index, Find()");
+    }
+
+    /// @brief Finds the index of the first element in the list that satisfies the given predicate.
+    /// @tparam Predicate The predicate function should take a const reference to the data type stored in the list and return a bool
+    /// @param pred The predicate to apply to each element in the list.
+    /// @return The index of the first element in the list that satisfies the predicate.
+    /// @throws LinkedListException if no element in the list satisfies the predicate.
+    template <typename Predicate>
+    int FindIndex(Predicate pred) const
+    {
+        int position = 0;
+
+        for (Node *node = _head; node; node = node->next)
+        {
+            for (int i = 0; i < node->count; i++)
+            {
+                if (pred(node->At(i)))
+                {
+                    return position + i;
+                }
+            }
+            position += node->count;
+        }
+        throw LinkedListException("Invalid index, FindIndex()");
+    }
+
+    /// @brief Function to find an element equal to a value.  Every node's elements are compared as one
+    /// contiguous run, with SSE2 or AVX2 compares when T is an arithmetic type.
+    /// @param value The value to look for
+    /// @return The first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    T FindValue(const T &value) const
+    {
+        for (Node *node = _head; node; node = node->next)
+        {
+            int index = SimdSearch<T>::FindFirst(node->Items(), node->count, value);
+            if (index >= 0)
+            {
+                return node->At(index);
+            }
+        }
+        throw LinkedListException("Invalid index, FindValue()");
+    }
+
+    /// @brief Finds the index of the first element equal to a value.  Compares like FindValue.
+    /// @param value The value to look for
+    /// @return The index of the first element equal to value
+    /// @throws LinkedListException if no element is equal to value
+    int FindIndexOfValue(const T &value) const
+    {
+        int position = 0;
+
+        for (Node *node = _head; node; node = node->next)
+        {
+            int index = SimdSearch<T>::FindFirst(node->Items(), node->count, value);
+            if (index >= 0)
+            {
+                return position + index;
+            }
+            position += node->count;
+        }
+        throw LinkedListException("Invalid index, FindIndexOfValue()");
+    }
+
+    /// @brief Counts the elements equal to a value.  Compares like FindValue.
+    /// @param value The value to count
+    /// @return The number of elements equal to value
+    int Count(const T &value) const
+    {
+        int matches = 0;
+
+        for (Node *node = _head; node; node = node->next)
+        {
+            matches += SimdSearch<T>::Count(node->Items(), node->count, value);
+        }
+        return matches;
+    }
+
+    /// @brief Applies a function to each element of the linked list.
+    /// @tparam Function The function should take a const reference to the data type stored in the list and return void.
+    /// @param func The function to apply.
+    template <typename Function>
+    void ForEach(Function func) const
+    {
+        for (Node *node = _head; node; node = node->next)
+        {
+            for (int i = 0; i < node->count; i++)
+            {
+                func(node->At(i));
+            }
+        }
+    }
+
+private:
+    /// @brief Node class holding up to N elements in uninitialized storage
+    class Node
+    {
+    public:
+        Node *next; ///< Pointer to the next node
+        int count;  ///< The number of constructed elements, always stored in items[0, count)
+
+        Node() : next(nullptr), count(0) {}
+
+        ~Node()
+        {
+            for (int i = 0; i < count; i++)
+            {
+                At(i).~T();
+            }
+        }
+
+        T &At(int index)
+        {
+            return *reinterpret_cast<T *>(&items[index]);
+        }
+
+        /// @brief The elements as one array of count values
+        const T *Items() const
+        {
+            return reinterpret_cast<const T *>(items);
+        }
+
+        /// @brief Constructs a copy of value at index, shifting the elements after it up by one.
+        void Insert(int index, const T &value)
+        {
+            if (index == count)
+            {
+                new (&items[count]) T(value);
+            }
+            else
+            {
+                // Build the copy first so a throwing copy constructor leaves the node untouched.
+                T copy(value);
+
+                new (&items[count]) T(std::move(At(count - 1)));
+                for (int i = count - 1; i > index; i--)
+                {
+                    At(i) = std::move(At(i - 1));
+                }
+                At(index) = std::move(copy);
+            }
+            count++;
+        }
+
+        /// @brief Destroys the element at index, shifting the elements after it down by one.
+        void Remove(int index)
+        {
+            for (int i = index; i < count - 1; i++)
+            {
+                At(i) = std::move(At(i + 1));
+            }
+            count--;
+            At(count).~T();
+        }
+
+        /// @brief Moves the elements [from, count) to the end of another node.
+        void MoveTail(int from, Node *other)
+        {
+            for (int i = from; i < count; i++)
+            {
+                new (&other->items[other->count]) T(std::move(At(i)));
+                other->count++;
+                At(i).~T();
+            }
+            count = from;
+        }
+
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type items[N]; ///< Storage for the elements
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+
+    /// @brief Finds the node holding a position.
+    /// @param offset The position to find.  On return, the offset of the element within the node.
+    /// @return The node holding the position
+    Node *Locate(int &offset) const
+    {
+        Node *node = _head;
+
+        while (offset >= node->count)
+        {
+            offset -= node->count;
+            node = node->next;
+        }
+        return node;
+    }
+
+    /// @brief Moves the upper half of a full node into a new node linked right after it.
+    void Split(Node *node)
+    {
+        Node *newNode = CreateNode();
+
+        node->MoveTail(N / 2, newNode);
+        LinkAfter(node, newNode);
+    }
+
+    /// @brief Moves all elements of the next node into this node and frees the next node.
+    void Merge(Node *node)
+    {
+        Node *next = node->next;
+
+        next->MoveTail(0, node);
+        Unlink(node, next);
+    }
+
+    /// @brief Links a node after prevNode, or at the head when prevNode is null.
+    void LinkAfter(Node *prevNode, Node *newNode)
+    {
+        if (prevNode == nullptr)
+        {
+            newNode->next = _head;
+            _head = newNode;
+        }
+        else
+        {
+            newNode->next = prevNode->next;
+            prevNode->next = newNode;
+        }
+
+        if (newNode->next == nullptr)
+        {
+            _tail = newNode;
+        }
+    }
+
+    /// @brief Unlinks and frees a node.  prevNode is null when node is the head.
+    void Unlink(Node *prevNode, Node *node)
+    {
+        if (prevNode == nullptr)
+        {
+            _head = node->next;
+        }
+        else
+        {
+            prevNode->next = node->next;
+        }
+
+        if (_tail == node)
+        {
+            _tail = prevNode;
+        }
+        DestroyNode(node);
+    }
+
+    Node *CreateNode()
+    {
+        Node *node = NodeAllocatorTraits::allocate(_allocator, 1);
+        NodeAllocatorTraits::construct(_allocator, node);
+        return node;
+    }
+
+    /// @brief Creates a node holding a copy of value.  The node is only linked once the copy succeeded, so a
+    /// throwing copy constructor never leaves an empty node in the list.
+    Node *CreateNode(const T &value)
+    {
+        Node *node = CreateNode();
+
+        try
+        {
+            node->Insert(0, value);
+        }
+        catch (...)
+        {
+            DestroyNode(node);
+            throw;
+        }
+        return node;
+    }
+
+    void DestroyNode(Node *node)
+    {
+        NodeAllocatorTraits::destroy(_allocator, node);
+        NodeAllocatorTraits::deallocate(_allocator, node, 1);
+    }
+
+    Node *_head; ///< Pointer to the first node
+    Node *_tail; ///< Pointer to the last node
+    int _size;   ///< The number of elements in the list
+
+    NodeAllocator _allocator; ///< Allocator used for every node in the list
+};